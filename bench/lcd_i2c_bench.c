@@ -0,0 +1,689 @@
+/**
+ * @author: Trong Phan Minh
+ * @date: 19/01/2026
+ * @brief: Host benchmark of the LCD1602 driver on the mock transport. Every scenario runs at 100, 400 and 1000kHz and prints one CSV line: I2C transactions, bytes on the wire, bus time and elapsed time (virtual, delays included) of one call, and the CPU time per call averaged over repeated calls.
+ * After the measured call and after the repeated calls, what the mock controllers show (DDRAM through the display window, CGRAM) is compared with what the calls asked for, mismatches are reported on stderr and counted in the last column.
+ * Build: cc -O2 -I. bench/lcd_i2c_bench.c lcd_i2c.c lcd_i2c_mock.c -o lcd_i2c_bench
+ * Usage: ./lcd_i2c_bench [repetitions] (default 2000)
+ */
+
+#define _POSIX_C_SOURCE 199309L // clock_gettime and CLOCK_PROCESS_CPUTIME_ID under -std=c11
+#include "lcd_i2c_mock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Macros
+#define BENCH_ADDRESS PCF8574_ADDRESS
+#define BENCH_DISPLAYS 8 // Displays of the shared bus scenarios
+#define BENCH_READY_ROW0 "Temp:   23.5 C" // Content of a ready display
+#define BENCH_READY_ROW1 "Hum:    45 %"
+#define BENCH_MARQUEE_SHORT "Ticker text that fits the 40 columns"
+#define BENCH_MARQUEE_LONG "Ticker text longer than the 40 DDRAM columns, refilled one column per step  "
+
+// Typedef
+typedef struct {
+    const char* name;
+    __UINT8_TYPE__ displays; // Number of displays the scenario drives, all on one bus
+    void (*setup)(__UINT32_TYPE__ busKhz); // Build the state the measured call starts from
+    void (*run)(__UINT32_TYPE__ i); // The measured call, i changes the content so repeated calls keep doing the same work
+    int (*check)(__UINT32_TYPE__ i); // Compare what the displays show after the call i with what was asked for, return the number of mismatches
+} Bench_Scenario_t;
+
+// Local variables
+static LCD1602_I2C_MockBus_t g_mock[BENCH_DISPLAYS]; // g_mock[0] is the bus, the others are devices added to it
+static LCD1602_I2C_t g_lcd[BENCH_DISPLAYS];
+static LCD1602_I2C_Sched_t g_sched;
+static LCD1602_I2C_Region_t g_regions[3]; // Status, clock and alarm regions of the same display
+static __UINT32_TYPE__ g_busKhz = 100;
+static __UINT8_TYPE__ g_displays = 1;
+static const char* g_scenarioName = ""; // Scenario being run, for the mismatch reports
+static const char* g_marqueeText = BENCH_MARQUEE_SHORT; // Text of the running marquee
+static LCD1602_I2C_Expander_t g_expander = LCD1602_I2C_PCF8574; // Expander of the next setup
+static const LCD1602_I2C_Glyph_t g_barGlyphs[5] = { // Bar graph cells filled with 1 to 5 columns
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},
+    {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},
+    {0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},
+    {0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},
+    {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F},
+};
+
+// Local functions declaration
+
+/**
+ * @brief Power up fresh mock devices on one bus and initialize a display context for each
+ * @name Bench_Setup
+ * @param busKhz: Bus clock in kHz
+ * @param displays: Number of displays
+ */
+static void Bench_Setup(__UINT32_TYPE__ busKhz, __UINT8_TYPE__ displays);
+
+/**
+ * @brief Get the CPU time of the process
+ * @name Bench_CpuNs
+ * @return Return the CPU time in ns
+ */
+static __UINT64_TYPE__ Bench_CpuNs(void);
+
+/**
+ * @brief Write 2 rows of 16 characters into the shadow framebuffer, every character differs between even and odd i
+ * @name Bench_FillRows
+ * @param lcd: Pointer to the display context
+ * @param i: Content selector
+ */
+static void Bench_FillRows(LCD1602_I2C_t* lcd, __UINT32_TYPE__ i);
+
+/**
+ * @brief Get the text Bench_FillRows writes into a row
+ * @name Bench_RowText
+ * @param i: Content selector
+ * @param row: The row, 0 or 1
+ * @return Return the 16 characters of the row
+ */
+static char* Bench_RowText(__UINT32_TYPE__ i, __UINT8_TYPE__ row);
+
+/**
+ * @brief Compare a row shown by a mock controller with the expected text, padded with spaces to the row width. A mismatch is reported on stderr.
+ * @name Bench_RowIs
+ * @param device: Index of the display in g_mock
+ * @param row: The row position
+ * @param columns: Number of visible columns
+ * @param expected: Expected characters (character codes), up to columns
+ * @return Return 0 when the row matches, 1 otherwise
+ */
+static int Bench_RowIs(__UINT8_TYPE__ device, __UINT8_TYPE__ row, __UINT8_TYPE__ columns, const char* expected);
+
+/**
+ * @brief Check that a cell of a mock controller shows a CGRAM character holding a glyph. A mismatch is reported on stderr.
+ * @name Bench_GlyphIs
+ * @param row: The row position
+ * @param x: The column position
+ * @param glyph: Expected 8 rows of the glyph, 0 to only check that the cell shows a CGRAM character
+ * @return Return 0 when the cell matches, 1 otherwise
+ */
+static int Bench_GlyphIs(__UINT8_TYPE__ row, __UINT8_TYPE__ x, const __UINT8_TYPE__* glyph);
+
+/**
+ * @brief Get the 80 characters Bench_RunWrapped shows on the 20x4 display
+ * @name Bench_WrappedText
+ * @param i: Content selector
+ * @return Return the text, 20 characters per row
+ */
+static const char* Bench_WrappedText(__UINT32_TYPE__ i);
+
+static void Bench_SetupBus(__UINT32_TYPE__ busKhz);
+static void Bench_SetupReady(__UINT32_TYPE__ busKhz);
+static void Bench_SetupShared(__UINT32_TYPE__ busKhz);
+static void Bench_SetupScheduled(__UINT32_TYPE__ busKhz);
+static void Bench_SetupGlyphs(__UINT32_TYPE__ busKhz);
+static void Bench_SetupUtf8(__UINT32_TYPE__ busKhz);
+static void Bench_Setup20x4(__UINT32_TYPE__ busKhz);
+static void Bench_SetupMarqueeShort(__UINT32_TYPE__ busKhz);
+static void Bench_SetupMarqueeLong(__UINT32_TYPE__ busKhz);
+static void Bench_SetupRegions(__UINT32_TYPE__ busKhz);
+static void Bench_SetupBus16(__UINT32_TYPE__ busKhz);
+static void Bench_SetupReady16(__UINT32_TYPE__ busKhz);
+static void Bench_RunInit(__UINT32_TYPE__ i);
+static void Bench_RunWarmStart(__UINT32_TYPE__ i);
+static void Bench_RunClear(__UINT32_TYPE__ i);
+static void Bench_RunMoveCursor(__UINT32_TYPE__ i);
+static void Bench_RunShowString(__UINT32_TYPE__ i);
+static void Bench_RunPrintf(__UINT32_TYPE__ i);
+static void Bench_RunRefreshFull(__UINT32_TYPE__ i);
+static void Bench_RunRefreshValue(__UINT32_TYPE__ i);
+static void Bench_RunGlyphBar(__UINT32_TYPE__ i);
+static void Bench_RunMarqueeStep(__UINT32_TYPE__ i);
+static void Bench_RunRegionBurst(__UINT32_TYPE__ i);
+static void Bench_RunScrub(__UINT32_TYPE__ i);
+static void Bench_RunUtf8Frame(__UINT32_TYPE__ i);
+static void Bench_RunWrapped(__UINT32_TYPE__ i);
+static void Bench_RunSharedSequential(__UINT32_TYPE__ i);
+static void Bench_RunSharedScheduled(__UINT32_TYPE__ i);
+static int Bench_CheckInit(__UINT32_TYPE__ i);
+static int Bench_CheckReady(__UINT32_TYPE__ i);
+static int Bench_CheckClear(__UINT32_TYPE__ i);
+static int Bench_CheckMoveCursor(__UINT32_TYPE__ i);
+static int Bench_CheckShowString(__UINT32_TYPE__ i);
+static int Bench_CheckPrintf(__UINT32_TYPE__ i);
+static int Bench_CheckRefreshFull(__UINT32_TYPE__ i);
+static int Bench_CheckRefreshValue(__UINT32_TYPE__ i);
+static int Bench_CheckGlyphBar(__UINT32_TYPE__ i);
+static int Bench_CheckMarquee(__UINT32_TYPE__ i);
+static int Bench_CheckRegions(__UINT32_TYPE__ i);
+static int Bench_CheckScrub(__UINT32_TYPE__ i);
+static int Bench_CheckUtf8Frame(__UINT32_TYPE__ i);
+static int Bench_CheckWrapped(__UINT32_TYPE__ i);
+static int Bench_CheckShared(__UINT32_TYPE__ i);
+
+// Scenarios
+static const Bench_Scenario_t g_scenarios[] = {
+    {"init", 1, Bench_SetupBus, Bench_RunInit, Bench_CheckInit},
+    {"warm_start", 1, Bench_SetupReady, Bench_RunWarmStart, Bench_CheckReady},
+    {"clear", 1, Bench_SetupReady, Bench_RunClear, Bench_CheckClear},
+    {"move_cursor", 1, Bench_SetupReady, Bench_RunMoveCursor, Bench_CheckMoveCursor},
+    {"show_string_16", 1, Bench_SetupReady, Bench_RunShowString, Bench_CheckShowString},
+    {"printf_value", 1, Bench_SetupReady, Bench_RunPrintf, Bench_CheckPrintf},
+    {"refresh_2x16_full", 1, Bench_SetupReady, Bench_RunRefreshFull, Bench_CheckRefreshFull},
+    {"refresh_2x16_value", 1, Bench_SetupReady, Bench_RunRefreshValue, Bench_CheckRefreshValue},
+    {"glyph_bar_16", 1, Bench_SetupGlyphs, Bench_RunGlyphBar, Bench_CheckGlyphBar},
+    {"marquee_step_40", 1, Bench_SetupMarqueeShort, Bench_RunMarqueeStep, Bench_CheckMarquee},
+    {"marquee_step_80", 1, Bench_SetupMarqueeLong, Bench_RunMarqueeStep, Bench_CheckMarquee},
+    {"region_burst_3x20", 1, Bench_SetupRegions, Bench_RunRegionBurst, Bench_CheckRegions},
+    {"scrub_8", 1, Bench_SetupReady, Bench_RunScrub, Bench_CheckScrub},
+    {"utf8_frame_2x16", 1, Bench_SetupUtf8, Bench_RunUtf8Frame, Bench_CheckUtf8Frame},
+    {"wrapped_20x4_full", 1, Bench_Setup20x4, Bench_RunWrapped, Bench_CheckWrapped},
+    {"init_pcf8575", 1, Bench_SetupBus16, Bench_RunInit, Bench_CheckInit},
+    {"show_string_16_pcf8575", 1, Bench_SetupReady16, Bench_RunShowString, Bench_CheckShowString},
+    {"refresh_2x16_full_pcf8575", 1, Bench_SetupReady16, Bench_RunRefreshFull, Bench_CheckRefreshFull},
+    {"shared_bus_8_sequential", BENCH_DISPLAYS, Bench_SetupShared, Bench_RunSharedSequential, Bench_CheckShared},
+    {"shared_bus_8_scheduled", BENCH_DISPLAYS, Bench_SetupScheduled, Bench_RunSharedScheduled, Bench_CheckShared},
+};
+
+
+// Local functions definition
+
+void Bench_Setup(__UINT32_TYPE__ busKhz, __UINT8_TYPE__ displays){
+    g_busKhz = busKhz;
+    g_displays = displays;
+    for(__UINT8_TYPE__ d = 0; d < displays; d++){
+        LCD1602_I2C_Mock_Init(&g_mock[d], BENCH_ADDRESS - 2 * d, busKhz, 0, 0);
+        g_mock[d].lcd.expander = (__UINT8_TYPE__)g_expander;
+        if(d) LCD1602_I2C_Mock_AddDevice(&g_mock[0], &g_mock[d]);
+    }
+    for(__UINT8_TYPE__ d = 0; d < displays; d++){
+        LCD1602_I2C_InitExpander(&g_lcd[d], &LCD1602_I2C_Transport_Mock, &g_mock[0], BENCH_ADDRESS - 2 * d, (__UINT16_TYPE__)busKhz, g_expander);
+    }
+}
+
+
+__UINT64_TYPE__ Bench_CpuNs(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (__UINT64_TYPE__)ts.tv_sec * 1000000000ULL + (__UINT64_TYPE__)ts.tv_nsec;
+}
+
+
+void Bench_FillRows(LCD1602_I2C_t* lcd, __UINT32_TYPE__ i){
+    LCD1602_I2C_ShadowWrite(lcd, 0, 0, Bench_RowText(i, 0));
+    LCD1602_I2C_ShadowWrite(lcd, 0, 1, Bench_RowText(i, 1));
+}
+
+
+char* Bench_RowText(__UINT32_TYPE__ i, __UINT8_TYPE__ row){
+    if(row == 0) return (i & 1) ? "ABCDEFGHIJKLMNOP" : "abcdefghijklmnop";
+    return (i & 1) ? "0123456789:;<=>?" : "QRSTUVWXYZ[\\]^_`";
+}
+
+
+int Bench_RowIs(__UINT8_TYPE__ device, __UINT8_TYPE__ row, __UINT8_TYPE__ columns, const char* expected){
+    char shown[41];
+    char padded[41];
+    size_t length = strlen(expected);
+
+    memset(padded, ' ', columns);
+    memcpy(padded, expected, (length < columns) ? length : columns);
+    padded[columns] = '\0';
+    LCD1602_I2C_Mock_ReadRow(&g_mock[device], row, shown, columns);
+    if(memcmp(shown, padded, columns) == 0) return 0;
+    fprintf(stderr, "%s,%u: display %u row %u shows \"%s\", expected \"%s\"\n", g_scenarioName, (unsigned)g_busKhz, (unsigned)device, (unsigned)row, shown, padded);
+    return 1;
+}
+
+
+int Bench_GlyphIs(__UINT8_TYPE__ row, __UINT8_TYPE__ x, const __UINT8_TYPE__* glyph){
+    char shown[41];
+    __UINT8_TYPE__ code = 0;
+
+    LCD1602_I2C_Mock_ReadRow(&g_mock[0], row, shown, 16);
+    code = (__UINT8_TYPE__)shown[x];
+    if(code < 8 && (!glyph || memcmp(&g_mock[0].lcd.cgram[code * 8], glyph, 8) == 0)) return 0;
+    fprintf(stderr, "%s,%u: row %u column %u shows 0x%02X, expected a CGRAM character%s\n", g_scenarioName, (unsigned)g_busKhz, (unsigned)row, (unsigned)x, code, glyph ? " with the glyph" : "");
+    return 1;
+}
+
+
+void Bench_SetupBus(__UINT32_TYPE__ busKhz){
+    g_busKhz = busKhz;
+    g_displays = 1;
+    LCD1602_I2C_Mock_Init(&g_mock[0], BENCH_ADDRESS, busKhz, 0, 0);
+    g_mock[0].lcd.expander = (__UINT8_TYPE__)g_expander;
+}
+
+
+void Bench_SetupReady(__UINT32_TYPE__ busKhz){
+    Bench_Setup(busKhz, 1);
+    LCD1602_I2C_ShadowWrite(&g_lcd[0], 0, 0, BENCH_READY_ROW0);
+    LCD1602_I2C_ShadowWrite(&g_lcd[0], 0, 1, BENCH_READY_ROW1);
+    LCD1602_I2C_Flush(&g_lcd[0]);
+    LCD1602_I2C_Mock_Advance(&g_mock[0], 2000); // Nothing left executing
+}
+
+
+void Bench_SetupShared(__UINT32_TYPE__ busKhz){
+    Bench_Setup(busKhz, BENCH_DISPLAYS);
+}
+
+
+void Bench_SetupScheduled(__UINT32_TYPE__ busKhz){
+    Bench_Setup(busKhz, BENCH_DISPLAYS);
+    LCD1602_I2C_SchedInit(&g_sched);
+    for(__UINT8_TYPE__ d = 0; d < BENCH_DISPLAYS; d++){
+        LCD1602_I2C_SchedAttach(&g_sched, &g_lcd[d]);
+    }
+}
+
+
+void Bench_SetupGlyphs(__UINT32_TYPE__ busKhz){
+    Bench_SetupReady(busKhz);
+    LCD1602_I2C_SetGlyphs(&g_lcd[0], g_barGlyphs, 5);
+    Bench_RunGlyphBar(0);
+    Bench_RunGlyphBar(1); // Every bar glyph is in CGRAM from now on
+    LCD1602_I2C_Mock_Advance(&g_mock[0], 2000);
+}
+
+
+void Bench_SetupUtf8(__UINT32_TYPE__ busKhz){
+    Bench_SetupReady(busKhz);
+    Bench_RunUtf8Frame(1); // Both fallback glyphs are in CGRAM from now on
+    LCD1602_I2C_Mock_Advance(&g_mock[0], 2000);
+}
+
+
+void Bench_Setup20x4(__UINT32_TYPE__ busKhz){
+    Bench_SetupReady(busKhz);
+    LCD1602_I2C_SetGeometry(&g_lcd[0], LCD1602_I2C_20X4);
+}
+
+
+void Bench_SetupMarqueeShort(__UINT32_TYPE__ busKhz){
+    Bench_SetupReady(busKhz);
+    g_marqueeText = BENCH_MARQUEE_SHORT;
+    LCD1602_I2C_MarqueeStart(&g_lcd[0], 0, g_marqueeText);
+    LCD1602_I2C_Mock_Advance(&g_mock[0], 2000);
+}
+
+
+void Bench_SetupMarqueeLong(__UINT32_TYPE__ busKhz){
+    Bench_SetupReady(busKhz);
+    g_marqueeText = BENCH_MARQUEE_LONG;
+    LCD1602_I2C_MarqueeStart(&g_lcd[0], 0, g_marqueeText);
+    LCD1602_I2C_Mock_Advance(&g_mock[0], 2000);
+}
+
+
+void Bench_SetupRegions(__UINT32_TYPE__ busKhz){
+    Bench_SetupReady(busKhz);
+    LCD1602_I2C_RegionAttach(&g_lcd[0], &g_regions[0], 0, 0, 6);
+    LCD1602_I2C_RegionAttach(&g_lcd[0], &g_regions[1], 8, 0, 8);
+    LCD1602_I2C_RegionAttach(&g_lcd[0], &g_regions[2], 0, 1, 16);
+}
+
+
+void Bench_SetupBus16(__UINT32_TYPE__ busKhz){
+    g_expander = LCD1602_I2C_PCF8575;
+    Bench_SetupBus(busKhz);
+    g_expander = LCD1602_I2C_PCF8574;
+}
+
+
+void Bench_SetupReady16(__UINT32_TYPE__ busKhz){
+    g_expander = LCD1602_I2C_PCF8575;
+    Bench_SetupReady(busKhz);
+    g_expander = LCD1602_I2C_PCF8574;
+}
+
+
+void Bench_RunInit(__UINT32_TYPE__ i){
+    (void)i;
+    LCD1602_I2C_InitExpander(&g_lcd[0], &LCD1602_I2C_Transport_Mock, &g_mock[0], BENCH_ADDRESS, (__UINT16_TYPE__)g_busKhz, (LCD1602_I2C_Expander_t)g_mock[0].lcd.expander);
+}
+
+
+void Bench_RunWarmStart(__UINT32_TYPE__ i){
+    (void)i;
+    LCD1602_I2C_WarmStart(&g_lcd[0], &LCD1602_I2C_Transport_Mock, &g_mock[0], BENCH_ADDRESS, (__UINT16_TYPE__)g_busKhz, LCD1602_I2C_PCF8574);
+}
+
+
+void Bench_RunClear(__UINT32_TYPE__ i){
+    (void)i;
+    LCD1602_I2C_Clear(&g_lcd[0]);
+}
+
+
+void Bench_RunMoveCursor(__UINT32_TYPE__ i){
+    LCD1602_I2C_MoveCursor(&g_lcd[0], (int)((i * 7 + 3) % 16), (int)(i & 1)); // Never where the cursor already is
+}
+
+
+void Bench_RunShowString(__UINT32_TYPE__ i){
+    (void)i;
+    LCD1602_I2C_ShowString(&g_lcd[0], "Hello, world! 16");
+}
+
+
+void Bench_RunPrintf(__UINT32_TYPE__ i){
+    LCD1602_I2C_MoveCursor(&g_lcd[0], 6, 0);
+    LCD1602_I2C_Printf(&g_lcd[0], "%6.1d C", (int)(i % 1000) - 400); // Fixed width, rewritten in place
+}
+
+
+void Bench_RunRefreshFull(__UINT32_TYPE__ i){
+    Bench_FillRows(&g_lcd[0], i);
+    LCD1602_I2C_Flush(&g_lcd[0]);
+}
+
+
+void Bench_RunRefreshValue(__UINT32_TYPE__ i){
+    char value[5];
+    snprintf(value, sizeof(value), "%02u.%u", (unsigned)(20 + i % 10), (unsigned)((i * 3) % 10));
+    LCD1602_I2C_ShadowWrite(&g_lcd[0], 8, 0, value);
+    LCD1602_I2C_Flush(&g_lcd[0]);
+}
+
+
+void Bench_RunGlyphBar(__UINT32_TYPE__ i){
+    __UINT32_TYPE__ level = (i & 1) ? 78 : 3 + i % 8; // Columns lit out of 80, a full sweep every other call
+
+    for(__UINT8_TYPE__ x = 0; x < 16; x++){
+        __INT32_TYPE__ lit = (__INT32_TYPE__)level - x * 5;
+        if(lit > 0) LCD1602_I2C_ShadowGlyph(&g_lcd[0], x, 1, (__UINT16_TYPE__)((lit >= 5) ? 4 : lit - 1));
+        else LCD1602_I2C_ShadowWrite(&g_lcd[0], x, 1, " ");
+    }
+    LCD1602_I2C_Flush(&g_lcd[0]);
+}
+
+
+void Bench_RunMarqueeStep(__UINT32_TYPE__ i){
+    (void)i;
+    LCD1602_I2C_MarqueeStep(&g_lcd[0]);
+}
+
+
+void Bench_RunRegionBurst(__UINT32_TYPE__ i){
+    for(__UINT32_TYPE__ k = 0; k < 20; k++){ // 20 posts per region between two refreshes, only the last ones are sent
+        __UINT32_TYPE__ n = i * 20 + k;
+        LCD1602_I2C_RegionPost(&g_regions[0], (n & 1) ? "RUN" : "IDLE");
+        LCD1602_I2C_RegionPrintf(&g_regions[1], "%02u:%02u:%02u", (unsigned)(n / 3600 % 24), (unsigned)(n / 60 % 60), (unsigned)(n % 60));
+        LCD1602_I2C_RegionPrintf(&g_regions[2], "Alarms: %u", (unsigned)(n % 7));
+    }
+    LCD1602_I2C_Refresh(&g_lcd[0]);
+}
+
+
+void Bench_RunScrub(__UINT32_TYPE__ i){
+    if(i % 10 == 1) g_mock[0].lcd.ddram[i % 40] ^= 0x01; // One corrupted cell now and then
+    LCD1602_I2C_Scrub(&g_lcd[0], 8);
+}
+
+
+void Bench_RunUtf8Frame(__UINT32_TYPE__ i){
+    // ROM characters (degree, micro, katakana) and 2 CGRAM fallbacks (e acute, euro), one line changes each frame
+    LCD1602_I2C_ShadowUtf8(&g_lcd[0], 0, 0, (i & 1) ? "Caf\xC3\xA9 21.5\xC2\xB0" "C  \xE2\x82\xAC" : "Caf\xC3\xA9 21.7\xC2\xB0" "C  \xE2\x82\xAC");
+    LCD1602_I2C_ShadowUtf8(&g_lcd[0], 0, 1, "\xE3\x83\x86\xE3\x82\xB9\xE3\x83\x88 12\xC2\xB5s");
+    LCD1602_I2C_Flush(&g_lcd[0]);
+}
+
+
+void Bench_RunWrapped(__UINT32_TYPE__ i){
+    // 80 characters from the top left corner, the text wraps through the 4 rows
+    LCD1602_I2C_ShowWrapped(&g_lcd[0], 0, 0, (char*)Bench_WrappedText(i));
+}
+
+
+void Bench_RunSharedSequential(__UINT32_TYPE__ i){
+    for(__UINT8_TYPE__ d = 0; d < g_displays; d++){ // Each display is cleared and redrawn before the next one starts
+        Bench_FillRows(&g_lcd[d], i);
+        LCD1602_I2C_ClearAsync(&g_lcd[d]);
+        LCD1602_I2C_FlushAsync(&g_lcd[d]);
+        LCD1602_I2C_Mock_DrainAsync(&g_mock[0], &g_lcd[d]);
+    }
+}
+
+
+void Bench_RunSharedScheduled(__UINT32_TYPE__ i){
+    for(__UINT8_TYPE__ d = 0; d < g_displays; d++){
+        Bench_FillRows(&g_lcd[d], i);
+        LCD1602_I2C_ClearAsync(&g_lcd[d]);
+        LCD1602_I2C_FlushAsync(&g_lcd[d]);
+    }
+    LCD1602_I2C_Mock_DrainSched(&g_mock[0], &g_sched);
+}
+
+
+const char* Bench_WrappedText(__UINT32_TYPE__ i){
+    return (i & 1) ? "Pump 1: RUN     3.2A Pump 2: STOP    0.0A Tank level: 78%     Alarms: none        "
+                   : "Pump 1: STOP    0.0A Pump 2: RUN     3.1A Tank level: 77%     Alarms: none        ";
+}
+
+
+int Bench_CheckInit(__UINT32_TYPE__ i){
+    int mismatches = 0;
+    (void)i;
+    mismatches += Bench_RowIs(0, 0, 16, "");
+    mismatches += Bench_RowIs(0, 1, 16, "");
+    if(g_mock[0].lcd.fourBit != (g_mock[0].lcd.expander == LCD1602_I2C_PCF8574) || !g_mock[0].lcd.twoLines || !g_mock[0].lcd.displayOn){
+        fprintf(stderr, "%s,%u: controller left in the wrong function set or display off\n", g_scenarioName, (unsigned)g_busKhz);
+        mismatches++;
+    }
+    return mismatches;
+}
+
+
+int Bench_CheckReady(__UINT32_TYPE__ i){
+    (void)i;
+    return Bench_RowIs(0, 0, 16, BENCH_READY_ROW0) + Bench_RowIs(0, 1, 16, BENCH_READY_ROW1);
+}
+
+
+int Bench_CheckClear(__UINT32_TYPE__ i){
+    (void)i;
+    return Bench_RowIs(0, 0, 16, "") + Bench_RowIs(0, 1, 16, "");
+}
+
+
+int Bench_CheckMoveCursor(__UINT32_TYPE__ i){
+    __UINT8_TYPE__ address = (__UINT8_TYPE__)(((i & 1) ? 0x40 : 0x00) + (i * 7 + 3) % 16);
+    int mismatches = Bench_CheckReady(i);
+
+    if(g_mock[0].lcd.ac != address || g_mock[0].lcd.cgramSelected){
+        fprintf(stderr, "%s,%u: address counter 0x%02X, expected 0x%02X\n", g_scenarioName, (unsigned)g_busKhz, g_mock[0].lcd.ac, address);
+        mismatches++;
+    }
+    return mismatches;
+}
+
+
+int Bench_CheckShowString(__UINT32_TYPE__ i){
+    int mismatches = Bench_RowIs(0, 0, 16, "Hello, world! 16"); // Every fifth call starts again at DDRAM 0x00
+    if(i == 0) mismatches += Bench_RowIs(0, 1, 16, BENCH_READY_ROW1);
+    return mismatches;
+}
+
+
+int Bench_CheckPrintf(__UINT32_TYPE__ i){
+    int value = (int)(i % 1000) - 400;
+    char number[8];
+    char expected[17];
+
+    snprintf(number, sizeof(number), "%s%d.%d", (value < 0) ? "-" : "", abs(value) / 10, abs(value) % 10);
+    snprintf(expected, sizeof(expected), "Temp: %6s C", number);
+    return Bench_RowIs(0, 0, 16, expected) + Bench_RowIs(0, 1, 16, BENCH_READY_ROW1);
+}
+
+
+int Bench_CheckRefreshFull(__UINT32_TYPE__ i){
+    return Bench_RowIs(0, 0, 16, Bench_RowText(i, 0)) + Bench_RowIs(0, 1, 16, Bench_RowText(i, 1));
+}
+
+
+int Bench_CheckRefreshValue(__UINT32_TYPE__ i){
+    char expected[17];
+    snprintf(expected, sizeof(expected), "Temp:   %02u.%u C", (unsigned)(20 + i % 10), (unsigned)((i * 3) % 10));
+    return Bench_RowIs(0, 0, 16, expected) + Bench_RowIs(0, 1, 16, BENCH_READY_ROW1);
+}
+
+
+int Bench_CheckGlyphBar(__UINT32_TYPE__ i){
+    __UINT32_TYPE__ level = (i & 1) ? 78 : 3 + i % 8;
+    int mismatches = Bench_RowIs(0, 0, 16, BENCH_READY_ROW0);
+    char shown[17];
+
+    LCD1602_I2C_Mock_ReadRow(&g_mock[0], 1, shown, 16);
+    for(__UINT8_TYPE__ x = 0; x < 16; x++){
+        __INT32_TYPE__ lit = (__INT32_TYPE__)level - x * 5;
+        if(lit > 0){
+            mismatches += Bench_GlyphIs(1, x, g_barGlyphs[(lit >= 5) ? 4 : lit - 1]);
+        } else if(shown[x] != ' '){
+            fprintf(stderr, "%s,%u: row 1 column %u shows 0x%02X, expected a space\n", g_scenarioName, (unsigned)g_busKhz, (unsigned)x, (__UINT8_TYPE__)shown[x]);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+
+int Bench_CheckMarquee(__UINT32_TYPE__ i){
+    __UINT32_TYPE__ steps = i ? i : 1; // The measured call is the first step, the repeated calls make i steps
+    __UINT32_TYPE__ length = (__UINT32_TYPE__)strlen(g_marqueeText);
+    __UINT32_TYPE__ loop = (length > 40) ? length : 40; // Short text is padded to the 40 columns
+    char expected[2][17];
+
+    for(__UINT8_TYPE__ x = 0; x < 16; x++){
+        __UINT32_TYPE__ k = (steps + x) % loop;
+        __UINT32_TYPE__ column = (steps + x) % 40; // The display shift scrolls row 1 too
+        expected[0][x] = (k < length) ? g_marqueeText[k] : ' ';
+        expected[1][x] = (column < sizeof(BENCH_READY_ROW1) - 1) ? BENCH_READY_ROW1[column] : ' ';
+    }
+    expected[0][16] = '\0';
+    expected[1][16] = '\0';
+    return Bench_RowIs(0, 0, 16, expected[0]) + Bench_RowIs(0, 1, 16, expected[1]);
+}
+
+
+int Bench_CheckRegions(__UINT32_TYPE__ i){
+    __UINT32_TYPE__ n = i * 20 + 19; // Last posts before the refresh
+    char expected[2][17];
+
+    snprintf(expected[0], sizeof(expected[0]), "%-6s  %02u:%02u:%02u", (n & 1) ? "RUN" : "IDLE", (unsigned)(n / 3600 % 24), (unsigned)(n / 60 % 60), (unsigned)(n % 60));
+    snprintf(expected[1], sizeof(expected[1]), "Alarms: %u", (unsigned)(n % 7));
+    return Bench_RowIs(0, 0, 16, expected[0]) + Bench_RowIs(0, 1, 16, expected[1]);
+}
+
+
+int Bench_CheckScrub(__UINT32_TYPE__ i){
+    __UINT32_TYPE__ corrupted = 0;
+    int mismatches = 0;
+
+    if(i == 0){ // No corruption yet, nothing may have been rewritten
+        LCD1602_I2C_ScrubStats(&g_lcd[0], 0, &corrupted);
+        if(corrupted){
+            fprintf(stderr, "%s,%u: %u cells counted as corrupted, expected none\n", g_scenarioName, (unsigned)g_busKhz, (unsigned)corrupted);
+            mismatches++;
+        }
+    }
+    LCD1602_I2C_Scrub(&g_lcd[0], 80); // One full pass repairs the cells corrupted after the last one the calls read
+    return mismatches + Bench_CheckReady(i);
+}
+
+
+int Bench_CheckUtf8Frame(__UINT32_TYPE__ i){
+    char shown[17];
+    int mismatches = Bench_RowIs(0, 1, 16, "\xC3\xBD\xC4 12\xE4s45 %"); // Katakana and micro sign from the A00 ROM, then the rest of the ready row
+
+    LCD1602_I2C_Mock_ReadRow(&g_mock[0], 0, shown, 16);
+    mismatches += Bench_GlyphIs(0, 3, 0) + Bench_GlyphIs(0, 13, 0); // e acute and euro sign from CGRAM
+    if(shown[3] == shown[13]){
+        fprintf(stderr, "%s,%u: e acute and euro sign share a CGRAM character\n", g_scenarioName, (unsigned)g_busKhz);
+        mismatches++;
+    }
+    shown[3] = 'e';
+    shown[13] = 'E';
+    if(strcmp(shown, (i & 1) ? "Cafe 21.5\xDF" "C  E  " : "Cafe 21.7\xDF" "C  E  ") != 0){
+        fprintf(stderr, "%s,%u: row 0 shows \"%s\"\n", g_scenarioName, (unsigned)g_busKhz, shown);
+        mismatches++;
+    }
+    return mismatches;
+}
+
+
+int Bench_CheckWrapped(__UINT32_TYPE__ i){
+    const char* text = Bench_WrappedText(i);
+    int mismatches = 0;
+    char expected[21];
+
+    for(__UINT8_TYPE__ row = 0; row < 4; row++){
+        memcpy(expected, text + row * 20, 20);
+        expected[20] = '\0';
+        mismatches += Bench_RowIs(0, row, 20, expected);
+    }
+    return mismatches;
+}
+
+
+int Bench_CheckShared(__UINT32_TYPE__ i){
+    int mismatches = 0;
+    for(__UINT8_TYPE__ d = 0; d < g_displays; d++){
+        mismatches += Bench_RowIs(d, 0, 16, Bench_RowText(i, 0)) + Bench_RowIs(d, 1, 16, Bench_RowText(i, 1));
+    }
+    return mismatches;
+}
+
+
+// Global functions definition
+
+int main(int argc, char** argv){
+    static const __UINT32_TYPE__ busKhz[] = {100, 400, 1000};
+    __UINT32_TYPE__ repetitions = (argc > 1) ? (__UINT32_TYPE__)strtoul(argv[1], 0, 10) : 2000;
+    int failed = 0;
+
+    if(repetitions == 0) repetitions = 1;
+    printf("scenario,bus_khz,transactions,bytes,bus_us,elapsed_us,cpu_ns,violations,mismatches\n");
+
+    for(__UINT32_TYPE__ s = 0; s < sizeof(g_scenarios) / sizeof(g_scenarios[0]); s++){
+        const Bench_Scenario_t* scenario = &g_scenarios[s];
+        g_scenarioName = scenario->name;
+
+        for(__UINT32_TYPE__ k = 0; k < sizeof(busKhz) / sizeof(busKhz[0]); k++){
+            LCD1602_I2C_MockBus_t* bus = &g_mock[0];
+            __UINT64_TYPE__ startNs = 0;
+            __UINT64_TYPE__ cpuNs = 0;
+            __UINT32_TYPE__ violations = 0;
+            __UINT32_TYPE__ mismatches = 0;
+            __UINT32_TYPE__ transactions = 0;
+            __UINT32_TYPE__ bytes = 0;
+            __UINT64_TYPE__ busNs = 0;
+            __UINT64_TYPE__ elapsedNs = 0;
+
+            // Traffic of one call
+            scenario->setup(busKhz[k]);
+            LCD1602_I2C_Mock_ResetCounters(bus);
+            startNs = bus->nowNs;
+            scenario->run(0);
+            transactions = bus->transactions;
+            bytes = bus->bytes;
+            busNs = bus->busNs;
+            elapsedNs = bus->nowNs - startNs;
+            for(__UINT8_TYPE__ d = 0; d < scenario->displays; d++){
+                violations += g_mock[d].lcd.violations;
+            }
+            mismatches += (__UINT32_TYPE__)scenario->check(0);
+
+            // CPU time per call, the virtual bus costs no real time
+            scenario->setup(busKhz[k]);
+            cpuNs = Bench_CpuNs();
+            for(__UINT32_TYPE__ i = 1; i <= repetitions; i++){
+                if(scenario->run == Bench_RunInit) scenario->setup(busKhz[k]); // Init needs a powered-down controller
+                scenario->run(i);
+            }
+            cpuNs = (Bench_CpuNs() - cpuNs) / repetitions;
+            mismatches += (__UINT32_TYPE__)scenario->check(repetitions);
+
+            printf("%s,%u,%u,%u,%llu,%llu,%llu,%u,%u\n", scenario->name, (unsigned)busKhz[k], (unsigned)transactions, (unsigned)bytes,
+                   (unsigned long long)(busNs / 1000), (unsigned long long)(elapsedNs / 1000), (unsigned long long)cpuNs, (unsigned)violations, (unsigned)mismatches);
+            if(violations || mismatches) failed = 1;
+        }
+    }
+    return failed; // Non-zero when the controller model saw an instruction it would have ignored, or a display does not show what was asked for
+}
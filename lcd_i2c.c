@@ -1,415 +1,2994 @@
 #include "lcd_i2c.h"
+#include <stdarg.h>
+#include <string.h>
 
 // Global variables
 
 
 // Local variables
-I2C_HandleTypeDef *g_hi2c;
-__UINT8_TYPE__ g_displayOffset = 0;
-__UINT8_TYPE__ g_cursorPos[2] = {0, 0};
+/*
+ * Frame lookup table, generated at compile time from the pin mapping in lcd_i2c.h
+ * - Indexed by [RS][data byte]
+ * - Low byte: the higher nibble on DB4..DB7 plus RS, high byte: the lower nibble on DB4..DB7 plus RS
+ * - EN, BL and R/~W are added when the frames are built
+ */
+#define LCD1602_I2C_FRAME_ENTRY(b, rs) (__UINT16_TYPE__)((LCD1602_I2C_NIBBLE_PINS((b) >> 4) | ((rs) ? PIN_RS : 0)) | ((LCD1602_I2C_NIBBLE_PINS((b) & 0x0F) | ((rs) ? PIN_RS : 0)) << 8))
+#define LCD1602_I2C_FRAME_ROW4(b, rs) LCD1602_I2C_FRAME_ENTRY((b), rs), LCD1602_I2C_FRAME_ENTRY((b) + 1, rs), LCD1602_I2C_FRAME_ENTRY((b) + 2, rs), LCD1602_I2C_FRAME_ENTRY((b) + 3, rs)
+#define LCD1602_I2C_FRAME_ROW16(b, rs) LCD1602_I2C_FRAME_ROW4((b), rs), LCD1602_I2C_FRAME_ROW4((b) + 4, rs), LCD1602_I2C_FRAME_ROW4((b) + 8, rs), LCD1602_I2C_FRAME_ROW4((b) + 12, rs)
+#define LCD1602_I2C_FRAME_ROW64(b, rs) LCD1602_I2C_FRAME_ROW16((b), rs), LCD1602_I2C_FRAME_ROW16((b) + 16, rs), LCD1602_I2C_FRAME_ROW16((b) + 32, rs), LCD1602_I2C_FRAME_ROW16((b) + 48, rs)
+#define LCD1602_I2C_FRAME_ROW256(rs) LCD1602_I2C_FRAME_ROW64(0, rs), LCD1602_I2C_FRAME_ROW64(64, rs), LCD1602_I2C_FRAME_ROW64(128, rs), LCD1602_I2C_FRAME_ROW64(192, rs)
+
+static const __UINT16_TYPE__ g_frameTable[2][256] = {
+    { LCD1602_I2C_FRAME_ROW256(0) }, // Instructions
+    { LCD1602_I2C_FRAME_ROW256(1) }  // Datas
+};
+
+/*
+ * Execution time of each instruction in us (HD44780U datasheet, fosc = 270kHz), indexed by the highest bit set in the instruction
+ * - Bit 0: Clear display, Bit 1: Return home, Bit 2..7: Entry mode set, Display control, Cursor/display shift, Function set, Set CGRAM/DDRAM address
+ * - Data writes/reads take 37us + 4us for the address counter update (tADD)
+ */
+static const __UINT16_TYPE__ g_execTimeUs[8] = {1520, 1520, 37, 37, 37, 37, 37, 37};
+#define LCD1602_I2C_DATA_EXEC_US 41
+
+/*
+ * Geometry table, generated at compile time and indexed by LCD1602_I2C_Geometry_t
+ * - Columns, rows, then the DDRAM address of the first column of each row, then the Function set N bit
+ * - Rows 2 and 3 of a 4 rows display continue rows 0 and 1 on their DDRAM line
+ * - 1 row displays run in 1 line mode (N = 0, 1/8 duty), DDRAM is one 80 characters line
+ */
+#define LCD1602_I2C_GEOMETRY(columns, rows) {columns, rows, 0x00, 0x40, ((rows) > 2) ? (columns) : 0x00, ((rows) > 2) ? 0x40 + (columns) : 0x40, ((rows) > 1) ? 1 : 0}
+
+static const __UINT8_TYPE__ g_geometry[6][7] = {
+    LCD1602_I2C_GEOMETRY(16, 2),
+    LCD1602_I2C_GEOMETRY(16, 1),
+    LCD1602_I2C_GEOMETRY(16, 4),
+    LCD1602_I2C_GEOMETRY(20, 2),
+    LCD1602_I2C_GEOMETRY(20, 4),
+    LCD1602_I2C_GEOMETRY(40, 2)
+};
+
+// Characters of a DDRAM line, the display shift wraps around it
+#define LCD1602_I2C_LINE_LENGTH(lcd) ((lcd)->twoLines ? 40 : 80)
+
+// Shadow framebuffer position written by LCD1602_I2C_ShadowPrintf
+typedef struct {
+    LCD1602_I2C_t* lcd;
+    __UINT8_TYPE__ x;
+    __UINT8_TYPE__ y;
+    __UINT8_TYPE__ end; // First column past the row
+} LCD1602_I2C_ShadowCursor_t;
+
+// Largest width, precision and %s length of a LCD1602_I2C_Format conversion, one DDRAM line
+#define LCD1602_I2C_FORMAT_MAX 40
+
+// Region text position written by LCD1602_I2C_RegionPrintf
+typedef struct {
+    LCD1602_I2C_Region_t* region;
+    __UINT8_TYPE__ x;
+} LCD1602_I2C_RegionCursor_t;
+
+/*
+ * Character ROM tables, generated from the character code tables of the HD44780U datasheet, sorted by codepoint for a binary search
+ * - Each entry maps the codepoints first..last to the character codes code..code + (last - first)
+ * - Codepoints that look alike share a code (micro sign and mu, degree sign and the handakuten of A00)
+ */
+typedef struct {
+    __UINT16_TYPE__ first;
+    __UINT16_TYPE__ last;
+    __UINT8_TYPE__ code;
+} LCD1602_I2C_RomRange_t;
+
+static const LCD1602_I2C_RomRange_t g_romA00[] = {
+    {0x0020, 0x005B, 0x20}, {0x005D, 0x007D, 0x5D}, {0x00A2, 0x00A2, 0xEC}, {0x00A5, 0x00A5, 0x5C},
+    {0x00B0, 0x00B0, 0xDF}, {0x00B5, 0x00B5, 0xE4}, {0x00DF, 0x00DF, 0xE2}, {0x00E4, 0x00E4, 0xE1},
+    {0x00F1, 0x00F1, 0xEE}, {0x00F6, 0x00F6, 0xEF}, {0x00F7, 0x00F7, 0xFD}, {0x00FC, 0x00FC, 0xF5},
+    {0x03A3, 0x03A3, 0xF6}, {0x03A9, 0x03A9, 0xF4}, {0x03B1, 0x03B1, 0xE0}, {0x03B2, 0x03B2, 0xE2}, {0x03B5, 0x03B5, 0xE3},
+    {0x03B8, 0x03B8, 0xF2}, {0x03BC, 0x03BC, 0xE4}, {0x03C0, 0x03C0, 0xF7}, {0x03C1, 0x03C1, 0xE6},
+    {0x03C3, 0x03C3, 0xE5}, {0x2126, 0x2126, 0xF4}, {0x2190, 0x2190, 0x7F}, {0x2192, 0x2192, 0x7E},
+    {0x221A, 0x221A, 0xE8}, {0x221E, 0x221E, 0xF3}, {0x2588, 0x2588, 0xFF}, {0x3001, 0x3001, 0xA4},
+    {0x3002, 0x3002, 0xA1}, {0x300C, 0x300D, 0xA2}, {0x309B, 0x309C, 0xDE}, {0x30FB, 0x30FB, 0xA5},
+    {0x30FC, 0x30FC, 0xB0}, {0x4E07, 0x4E07, 0xFB}, {0x5186, 0x5186, 0xFC}, {0x5343, 0x5343, 0xFA},
+    {0xFF61, 0xFF9F, 0xA1}
+};
+
+static const LCD1602_I2C_RomRange_t g_romA02[] = {
+    {0x0020, 0x007E, 0x20}, {0x00A0, 0x00A7, 0xA0}, {0x00A9, 0x00AB, 0xA9}, {0x00AE, 0x00AE, 0xAE},
+    {0x00B0, 0x00B3, 0xB0}, {0x00B5, 0x00B7, 0xB5}, {0x00B9, 0x00FF, 0xB9}
+};
+
+/*
+ * Full-width katakana U+30A1..U+30F4 on the half-width katakana of the A00 ROM, indexed by codepoint - 0x30A1
+ * - Low byte: character code, high byte: dakuten (0xDE) or handakuten (0xDF) shown in the next cell, 0 for none
+ * - 0: not in the ROM (small wa, wi, we)
+ */
+static const __UINT16_TYPE__ g_kanaA00[0x54] = {
+    0x00A7, 0x00B1, 0x00A8, 0x00B2, 0x00A9, 0x00B3, 0x00AA, 0x00B4, 0x00AB, 0x00B5, 0x00B6, 0xDEB6, 0x00B7, 0xDEB7, 0x00B8, 0xDEB8,
+    0x00B9, 0xDEB9, 0x00BA, 0xDEBA, 0x00BB, 0xDEBB, 0x00BC, 0xDEBC, 0x00BD, 0xDEBD, 0x00BE, 0xDEBE, 0x00BF, 0xDEBF, 0x00C0, 0xDEC0,
+    0x00C1, 0xDEC1, 0x00AF, 0x00C2, 0xDEC2, 0x00C3, 0xDEC3, 0x00C4, 0xDEC4, 0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0xDECA,
+    0xDFCA, 0x00CB, 0xDECB, 0xDFCB, 0x00CC, 0xDECC, 0xDFCC, 0x00CD, 0xDECD, 0xDFCD, 0x00CE, 0xDECE, 0xDFCE, 0x00CF, 0x00D0, 0x00D1,
+    0x00D2, 0x00D3, 0x00AC, 0x00D4, 0x00AD, 0x00D5, 0x00AE, 0x00D6, 0x00D7, 0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x0000, 0x00DC, 0x0000,
+    0x0000, 0x00A6, 0x00DD, 0xDEB3
+};
+
+// Built-in UTF-8 glyph table, characters missing from one of the ROMs (sorted by codepoint)
+static const LCD1602_I2C_Utf8Glyph_t g_utf8Glyphs[] = {
+    {0x005C, {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00}}, // Backslash (A00)
+    {0x007E, {0x00, 0x00, 0x00, 0x0D, 0x12, 0x00, 0x00, 0x00}}, // Tilde (A00)
+    {0x00C4, {0x0A, 0x00, 0x0E, 0x11, 0x1F, 0x11, 0x11, 0x00}}, // A with diaeresis
+    {0x00D6, {0x0A, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00}}, // O with diaeresis
+    {0x00DC, {0x0A, 0x00, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00}}, // U with diaeresis
+    {0x00E0, {0x08, 0x04, 0x0E, 0x01, 0x0F, 0x11, 0x0F, 0x00}}, // a with grave
+    {0x00E7, {0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E, 0x04, 0x0C}}, // c with cedilla
+    {0x00E8, {0x08, 0x04, 0x0E, 0x11, 0x1F, 0x10, 0x0E, 0x00}}, // e with grave
+    {0x00E9, {0x02, 0x04, 0x0E, 0x11, 0x1F, 0x10, 0x0E, 0x00}}, // e with acute
+    {0x00EA, {0x04, 0x0A, 0x0E, 0x11, 0x1F, 0x10, 0x0E, 0x00}}, // e with circumflex
+    {0x20AC, {0x06, 0x09, 0x1C, 0x08, 0x1C, 0x09, 0x06, 0x00}}, // Euro sign
+    {0x2190, {0x00, 0x04, 0x08, 0x1F, 0x08, 0x04, 0x00, 0x00}}, // Left arrow (A02)
+    {0x2191, {0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x04, 0x00}}, // Up arrow
+    {0x2192, {0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00}}, // Right arrow (A02)
+    {0x2193, {0x04, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04, 0x00}}  // Down arrow
+};
+
+// Continuation bytes following a UTF-8 lead byte, indexed by (lead byte >> 3) & 0x07 for 0xC0..0xFF, 0 for the invalid 0xF8..0xFF
+static const __UINT8_TYPE__ g_utf8Length[8] = {1, 1, 1, 1, 2, 2, 3, 0};
+
+// Smallest codepoint of a sequence, indexed by its continuation bytes (a smaller one is an overlong encoding)
+static const __UINT32_TYPE__ g_utf8Min[4] = {0, 0x80, 0x800, 0x10000};
+
+/*
+ * Instrumentation hooks, without LCD1602_I2C_TRACE they expand to nothing (or to the bare transport call) and the context has no trace fields
+ * - LCD1602_I2C_TRACE_API: first statement of an instrumented public call, times it up to whichever return it leaves by (cleanup attribute)
+ * - LCD1602_I2C_TRACE_BUS: wraps a transport call, counts the transaction and logs its bytes in the trace ring
+ * - LCD1602_I2C_TRACE_SEGMENTS: the same for a transaction of several messages (transport transfer function)
+ * - LCD1602_I2C_TRACE_COUNT: adds to one counter
+ */
+#if LCD1602_I2C_TRACE
+typedef struct {
+    LCD1602_I2C_t* lcd;
+    __UINT32_TYPE__ start; // Timestamp (us) at which the call started
+    __UINT8_TYPE__ api; // LCD1602_I2C_Api_t, LCD1602_I2C_API_COUNT for a call made inside another one
+} LCD1602_I2C_TraceScope_t;
+
+#define LCD1602_I2C_TRACE_API(lcd, api) LCD1602_I2C_TraceScope_t traceScope __attribute__((cleanup(LCD1602_I2C_TraceLeave))) = LCD1602_I2C_TraceEnter((lcd), (api))
+#define LCD1602_I2C_TRACE_BUS(lcd, flags, data, length, call) __extension__ ({ __UINT32_TYPE__ traceStart = LCD1602_I2C_Micros(lcd); LCD1602_I2C_Status_t traceStatus = (call); LCD1602_I2C_TraceBus((lcd), (flags), (data), (length), traceStart, traceStatus); })
+#define LCD1602_I2C_TRACE_SEGMENTS(lcd, segments, count, call) __extension__ ({ __UINT32_TYPE__ traceStart = LCD1602_I2C_Micros(lcd); LCD1602_I2C_Status_t traceStatus = (call); LCD1602_I2C_TraceSegments((lcd), (segments), (count), traceStart, traceStatus); })
+#define LCD1602_I2C_TRACE_COUNT(lcd, counter, n) ((lcd)->trace.counter += (n))
+#else
+#define LCD1602_I2C_TRACE_API(lcd, api)
+#define LCD1602_I2C_TRACE_BUS(lcd, flags, data, length, call) (call)
+#define LCD1602_I2C_TRACE_SEGMENTS(lcd, segments, count, call) (call)
+#define LCD1602_I2C_TRACE_COUNT(lcd, counter, n) ((void)0)
+#endif
 
 // Local functions declaration
 
 /**
  * @brief Clears entire display and sets DDRAM address 0 in address counter. (Implemented in 4 bit mode)
  * @name LCD1602_I2C_Clear_Display
+ * @param lcd: Pointer to the display context
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_Clear_Display(void);
-
-/**
- * @brief  Sets DDRAM address 0 in address counter. Also returns display from being shifted to original position. DDRAM contents remain unchanged. (Implemented in 4 bit mode)
- * @name LCD1602_I2C_ReturnHome
- * @return Return the function status
- */
-static LCD1602_I2C_Status_t LCD1602_I2C_ReturnHome(void);
+static LCD1602_I2C_Status_t LCD1602_I2C_Clear_Display(LCD1602_I2C_t* lcd);
 
 /**
  * @brief  Sets cursor move direction and specifies display shift. These operations are performed during data write and read. (Implemented in 4 bit mode)
  * @name LCD1602_I2C_EntryModeSet
+ * @param lcd: Pointer to the display context
  * @param increment: Set to 1 to increment the cursor position, 0 to decrement
  * @param shift: Set to 1 to shift the display, 0 to not shift
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_EntryModeSet(__UINT8_TYPE__ increment, __UINT8_TYPE__ shift);
+static LCD1602_I2C_Status_t LCD1602_I2C_EntryModeSet(LCD1602_I2C_t* lcd, __UINT8_TYPE__ increment, __UINT8_TYPE__ shift);
 
 /**
  * @brief Sets entire display (D) on/off, cursor on/off (C), and blinking of cursor position character (B). (Implemented in 4 bit mode)
  * @name LCD1602_I2C_DisplayControl
+ * @param lcd: Pointer to the display context
  * @param displayOn: Set to 1 to turn on the display, 0 to turn off
  * @param cursorOn: Set to 1 to turn on the cursor, 0 to turn off
  * @param blinkOn: Set to 1 to turn on the blinking cursor, 0 to turn off
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_DisplayControl(__UINT8_TYPE__ displayOn, __UINT8_TYPE__ cursorOn, __UINT8_TYPE__ blinkOn);
+static LCD1602_I2C_Status_t LCD1602_I2C_DisplayControl(LCD1602_I2C_t* lcd, __UINT8_TYPE__ displayOn, __UINT8_TYPE__ cursorOn, __UINT8_TYPE__ blinkOn);
 
 /**
  * @brief  Moves cursor and shifts display without changing DDRAM contents. (Implemented in 4 bit mode)
  * @name LCD1602_I2C_CursorDisplayShift
+ * @param lcd: Pointer to the display context
  * @param shiftDisplay: Set to 1 to shift display, 0 to move cursor
  * @param shiftRight: Set to 1 to shift/move right, 0 to shift/move left
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_CursorDisplayShift(__UINT8_TYPE__ shiftDisplay, __UINT8_TYPE__ shiftRight);
+static LCD1602_I2C_Status_t LCD1602_I2C_CursorDisplayShift(LCD1602_I2C_t* lcd, __UINT8_TYPE__ shiftDisplay, __UINT8_TYPE__ shiftRight);
 
 /**
- * @brief Sets number of display lines (N), and character font (F). This function doesn't has data length because it is always 4-bit mode. (Implemented in 4 bit mode)
+ * @brief Sets number of display lines (N), and character font (F). This function doesn't has data length because it is always 4-bit mode (8-bit mode behind a PCF8575). (Implemented in 4 bit mode)
  * @name LCD1602_I2C_FunctionSet
+ * @param lcd: Pointer to the display context
  * @param numLines: Set to 1 for 2 lines, 0 for 1 line
  * @param fontType: Set to 1 for 5x10 dots, 0 for 5x8 dots
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_FunctionSet(__UINT8_TYPE__ numLines, __UINT8_TYPE__ fontType);
+static LCD1602_I2C_Status_t LCD1602_I2C_FunctionSet(LCD1602_I2C_t* lcd, __UINT8_TYPE__ numLines, __UINT8_TYPE__ fontType);
 
 /**
  * @brief Sets CGRAM address. CGRAM data is sent and received after this setting. (Implemented in 4 bit mode)
  * @name LCD1602_I2C_SetCGRAMAddress
+ * @param lcd: Pointer to the display context
  * @param address: The CGRAM address to set (0-63)
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_SetCGRAMAddress(__UINT8_TYPE__ address);
+static LCD1602_I2C_Status_t LCD1602_I2C_SetCGRAMAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ address);
 
 /**
  * @brief Sets DDRAM address. DDRAM data is sent and received after this setting. (Implemented in 4 bit mode)
  * @name LCD1602_I2C_SetDDRAMAddress
+ * @param lcd: Pointer to the display context
  * @param address: The DDRAM address to set (0-79)
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_SetDDRAMAddress(__UINT8_TYPE__ address);
+static LCD1602_I2C_Status_t LCD1602_I2C_SetDDRAMAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ address);
 
 /**
  * @brief  Reads busy flag (BF) indicating internal operation is being performed and reads address counter contents. (Implemented in 4 bit mode)
  * @name LCD1602_I2C_Read_BusyFlag_Address
+ * @param lcd: Pointer to the display context
  * @param address: Pointer to store the address counter value, only the lower 7 bits are valid. The busy flag is stored in the highest bit (bit 7).
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_Read_BusyFlag_Address(__UINT8_TYPE__* address);
+static LCD1602_I2C_Status_t LCD1602_I2C_Read_BusyFlag_Address(LCD1602_I2C_t* lcd, __UINT8_TYPE__* address);
 
 /**
  * @brief Writes data into DDRAM or CGRAM. (Dependent on the previous setting of DDRAM/CGRAM address). (Implemented in 4 bit mode)
  * @name LCD1602_I2C_Write_Data
+ * @param lcd: Pointer to the display context
  * @param data: The data to write
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_Write_Data(__UINT8_TYPE__ data);
+static LCD1602_I2C_Status_t LCD1602_I2C_Write_Data(LCD1602_I2C_t* lcd, __UINT8_TYPE__ data);
 
 /**
- * @brief Reads data from DDRAM or CGRAM. (Dependent on the previous setting of DDRAM/CGRAM address). (Implemented in 4 bit mode)
+ * @brief Reads data from DDRAM or CGRAM. (Dependent on the previous setting of DDRAM/CGRAM address, sent again when a data write came since). (Implemented in 4 bit mode)
  * @name LCD1602_I2C_Read_Data
+ * @param lcd: Pointer to the display context
  * @param data: Pointer to store the read data
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_Read_Data(__UINT8_TYPE__* data);
+static LCD1602_I2C_Status_t LCD1602_I2C_Read_Data(LCD1602_I2C_t* lcd, __UINT8_TYPE__* data);
 
 /**
  * @brief Set the LCD1602 to operate in 4 bits mode.
  * @name LCD1602_I2C_Set4BitMode
+ * @param lcd: Pointer to the display context
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_Set4BitMode(void);
+static LCD1602_I2C_Status_t LCD1602_I2C_Set4BitMode(LCD1602_I2C_t* lcd);
 
 /**
- * @brief This is the main function that sends instructions/datas to the LCD1602. In 4 bits mode, only DB4 to DB7 are used for transfer, while DB0 to DB3 are not used. When using 4 bit mode, instructions/datas are sent in two phases: first the higher nibble (DB7 to DB4), then the lower nibble (DB3 to DB0). Both phases are sent through DB4-DB7, the Enable pulse notifies the HD44780U about the phases. When a read operation is performed, the data read from the LCD1602 is stored back into the variable pointed by "cmd". (Implemented in 4 bit mode)
+ * @brief This is the main function that sends instructions/datas to the LCD1602. In 4 bits mode, only DB4 to DB7 are used for transfer, while DB0 to DB3 are not used. When using 4 bit mode, instructions/datas are sent in two phases: first the higher nibble (DB7 to DB4), then the lower nibble (DB3 to DB0). Both phases are sent through DB4-DB7, the Enable pulse notifies the HD44780U about the phases. The four frames are queued in the burst buffer and sent immediately unless a burst is open. When a read operation is performed, the data read from the LCD1602 is stored back into the variable pointed by "cmd". Behind a PCF8575 the instruction/data goes out whole on DB0 to DB7 in two port writes. (Implemented in 4 bit mode)
  * @name LCD1602_I2C_SendToLCD
+ * @param lcd: Pointer to the display context
  * @param data: The data that needs to be sent (cmd, addr, request), only the first 10 bits are valid
  * @param isBacklightOn: Set to 1 to turn on backlight, 0 to turn off backlight
  * @return Return the function status
  */
-static LCD1602_I2C_Status_t LCD1602_I2C_SendToLCD(__UINT16_TYPE__* data, __UINT8_TYPE__ isBacklightOn);
+static LCD1602_I2C_Status_t LCD1602_I2C_SendToLCD(LCD1602_I2C_t* lcd, __UINT16_TYPE__* data, __UINT8_TYPE__ isBacklightOn);
+
+/**
+ * @brief Compute the DDRAM address shown at a display position, taking the current display shift into account.
+ * @name LCD1602_I2C_CellAddress
+ * @param lcd: Pointer to the display context
+ * @param x: The column position (0 to 39)
+ * @param y: The row position (0 or 1)
+ * @return Return the DDRAM address
+ */
+static __UINT8_TYPE__ LCD1602_I2C_CellAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ x, __UINT8_TYPE__ y);
+
+/**
+ * @brief Find the entry of the DDRAM model holding a DDRAM address. In 1 line mode the 80 characters line runs over both rows of the model.
+ * @name LCD1602_I2C_DdramCell
+ * @param lcd: Pointer to the display context
+ * @param address: The DDRAM address (0x00 to 0x27 or 0x40 to 0x67, 0x00 to 0x4F in 1 line mode)
+ * @return Return a pointer to the entry
+ */
+static __UINT8_TYPE__* LCD1602_I2C_DdramCell(LCD1602_I2C_t* lcd, __UINT8_TYPE__ address);
 
+/**
+ * @brief Map a display position to its line and column in the shadow framebuffer, as used by LCD1602_I2C_CellAddress, following the geometry.
+ * @name LCD1602_I2C_RowCell
+ * @param lcd: Pointer to the display context
+ * @param x: The column position
+ * @param y: The row position
+ * @param line: Pointer to store the line (0 or 1)
+ * @param end: Pointer to store the first column past the row on the line
+ * @return Return the column on the line, 0xFF if the position is outside the geometry
+ */
+static __UINT8_TYPE__ LCD1602_I2C_RowCell(LCD1602_I2C_t* lcd, int x, int y, __UINT8_TYPE__* line, __UINT8_TYPE__* end);
+
+/**
+ * @brief Move the modelled address counter by one position, like the HD44780U does after a data write/read or a cursor shift. In 2 lines mode DDRAM 0x27 is followed by 0x40 and 0x67 by 0x00, in 1 line mode 0x4F by 0x00, CGRAM wraps at 0x3F.
+ * @name LCD1602_I2C_StepAddress
+ * @param lcd: Pointer to the display context
+ * @param increment: Set to 1 to move forward, 0 to move backward
+ */
+static void LCD1602_I2C_StepAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ increment);
 
+/**
+ * @brief Mark every CGRAM character as holding no known glyph, after CGRAM may have been written partially
+ * @name LCD1602_I2C_GlyphForget
+ * @param lcd: Pointer to the display context
+ */
+static void LCD1602_I2C_GlyphForget(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Find the CGRAM character holding a glyph.
+ * @name LCD1602_I2C_GlyphFind
+ * @param lcd: Pointer to the display context
+ * @param id: The glyph id
+ * @return Return the CGRAM character (0 to 7), 0xFF if the glyph is not in CGRAM
+ */
+static __UINT8_TYPE__ LCD1602_I2C_GlyphFind(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id);
+
+/**
+ * @brief Get the CGRAM character of a glyph, uploading the glyph over the least recently used character outside of pinned on a miss. The address counter is left in CGRAM after an upload.
+ * @name LCD1602_I2C_GlyphLoad
+ * @param lcd: Pointer to the display context
+ * @param id: The glyph id, already checked against the table
+ * @param pinned: Bit mask of the CGRAM characters that must not be replaced
+ * @param slot: Pointer to store the CGRAM character (0 to 7)
+ * @return Return the function status, LCD1602_I2C_ERROR if every character is pinned
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_GlyphLoad(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id, __UINT8_TYPE__ pinned, __UINT8_TYPE__* slot);
+
+/**
+ * @brief Give the glyphs drawn in the shadow framebuffer a CGRAM character each and put the character codes in the shadow cells. Glyphs already in CGRAM are pinned first so the uploads of the new ones never replace a glyph the frame shows.
+ * @name LCD1602_I2C_ShadowLoadGlyphs
+ * @param lcd: Pointer to the display context
+ * @return Return the function status, LCD1602_I2C_ERROR if the frame uses more than 8 different glyphs or an unregistered one
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_ShadowLoadGlyphs(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Get the bitmap of a glyph id, from the glyph table or the UTF-8 glyph table (LCD1602_I2C_GLYPH_UTF8 set).
+ * @name LCD1602_I2C_GlyphBitmap
+ * @param lcd: Pointer to the display context
+ * @param id: The glyph id
+ * @return Return the 8 pixel rows, 0 if the id is not registered
+ */
+static const __UINT8_TYPE__* LCD1602_I2C_GlyphBitmap(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id);
+
+/**
+ * @brief Feed one byte of UTF-8 text to a decoder. Invalid sequences (stray or missing continuation bytes, overlong encodings, surrogates, codepoints above U+10FFFF) give U+FFFD.
+ * @name LCD1602_I2C_Utf8Decode
+ * @param decoder: Pointer to the decoder state, zeroed before the first byte
+ * @param byte: The next byte of the text
+ * @param codepoints: Pointer to store the codepoints completed by the byte (2 when it cuts a sequence short and is ASCII)
+ * @return Return the number of codepoints completed, 0 to 2
+ */
+static __UINT8_TYPE__ LCD1602_I2C_Utf8Decode(LCD1602_I2C_Utf8Decoder_t* decoder, __UINT8_TYPE__ byte, __UINT32_TYPE__* codepoints);
+
+/**
+ * @brief Map a codepoint to the cells showing it: character codes of the selected ROM, a UTF-8 glyph, or LCD1602_I2C_UTF8_REPLACEMENT.
+ * @name LCD1602_I2C_Utf8Map
+ * @param lcd: Pointer to the display context
+ * @param codepoint: The Unicode codepoint
+ * @param cells: Pointer to store the cells, character codes (below 0x100) or glyph ids (LCD1602_I2C_GLYPH_UTF8 set)
+ * @return Return the number of cells, 1 or 2
+ */
+static __UINT8_TYPE__ LCD1602_I2C_Utf8Map(LCD1602_I2C_t* lcd, __UINT32_TYPE__ codepoint, __UINT16_TYPE__* cells);
+
+/**
+ * @brief Write marquee characters into the DDRAM columns of a row, counted from the column shown in the first display column. Cells that already hold the right character are skipped. The entry mode is switched to increment without shift when needed and left so, the caller puts it back.
+ * @name LCD1602_I2C_MarqueeRefill
+ * @param lcd: Pointer to the display context
+ * @param y: The row (0 or 1)
+ * @param from: First column, relative to the first display column (0 to 39)
+ * @param count: Number of columns
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_MarqueeRefill(LCD1602_I2C_t* lcd, __UINT8_TYPE__ y, __UINT8_TYPE__ from, __UINT8_TYPE__ count);
+
+/**
+ * @brief Format a string without libc, every character is handed to put as soon as it is produced (nothing is buffered besides the digits of one number). See LCD1602_I2C_Printf for the conversions.
+ * @name LCD1602_I2C_Format
+ * @param put: Function receiving the characters, the formatting stops at its first failure
+ * @param ctx: Passed to put
+ * @param fmt: Pointer to the null-terminated format string
+ * @param args: The arguments of the conversions
+ * @return Return the function status, LCD1602_I2C_ERROR on an unknown conversion
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Format(LCD1602_I2C_Status_t (*put)(void* ctx, __UINT8_TYPE__ c), void* ctx, const char* fmt, va_list args);
+
+/**
+ * @brief LCD1602_I2C_Format output to the display at the cursor.
+ * @name LCD1602_I2C_PutDisplay
+ * @param ctx: Pointer to the display context
+ * @param c: The character
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_PutDisplay(void* ctx, __UINT8_TYPE__ c);
+
+/**
+ * @brief LCD1602_I2C_Format output to the shadow framebuffer, characters past column 39 are dropped.
+ * @name LCD1602_I2C_PutShadow
+ * @param ctx: Pointer to a LCD1602_I2C_ShadowCursor_t
+ * @param c: The character
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_PutShadow(void* ctx, __UINT8_TYPE__ c);
+
+/**
+ * @brief LCD1602_I2C_Format output to a region text, characters past the region width are dropped.
+ * @name LCD1602_I2C_PutRegion
+ * @param ctx: Pointer to a LCD1602_I2C_RegionCursor_t
+ * @param c: The character
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_PutRegion(void* ctx, __UINT8_TYPE__ c);
+
+/**
+ * @brief Start a post, the sequence turns odd so the refresh leaves the text alone
+ * @name LCD1602_I2C_RegionPostBegin
+ * @param region: Pointer to the region
+ */
+static void LCD1602_I2C_RegionPostBegin(LCD1602_I2C_Region_t* region);
+
+/**
+ * @brief End a post, the text is padded with spaces and the sequence turns even again
+ * @name LCD1602_I2C_RegionPostEnd
+ * @param region: Pointer to the region
+ * @param length: Number of characters written by the post
+ */
+static void LCD1602_I2C_RegionPostEnd(LCD1602_I2C_Region_t* region, __UINT8_TYPE__ length);
+
+/**
+ * @brief Copy the text of every region posted since the last refresh into the shadow framebuffer, a region in the middle of a post is left for the next refresh
+ * @name LCD1602_I2C_RegionCollect
+ * @param lcd: Pointer to the display context
+ */
+static void LCD1602_I2C_RegionCollect(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Rate limited refresh shared by LCD1602_I2C_Refresh and LCD1602_I2C_RefreshAsync
+ * @name LCD1602_I2C_RefreshFrame
+ * @param lcd: Pointer to the display context
+ * @param flush: LCD1602_I2C_Flush or LCD1602_I2C_FlushAsync
+ * @return Return the status of the flush, LCD1602_I2C_OK when nothing was due
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_RefreshFrame(LCD1602_I2C_t* lcd, LCD1602_I2C_Status_t (*flush)(LCD1602_I2C_t* lcd));
+
+/**
+ * @brief Encode one instruction/data into the four PCF8574 frames of a 4-bit transfer: higher nibble with EN set, EN cleared, lower nibble with EN set, EN cleared.
+ * @name LCD1602_I2C_EncodeFrames
+ * @param cmd: The data that needs to be encoded (cmd, addr, request), only the first 10 bits are valid
+ * @param isBacklightOn: Set to 1 to turn on backlight, 0 to turn off backlight
+ * @param frames: Pointer to an array of at least 4 bytes receiving the frames
+ */
+static void LCD1602_I2C_EncodeFrames(__UINT16_TYPE__ cmd, __UINT8_TYPE__ isBacklightOn, __UINT8_TYPE__* frames);
+
+/**
+ * @brief Encode one instruction/data into the two PCF8575 port writes of an 8-bit transfer: DB0..DB7 with EN set, then EN cleared. Each port write is 2 bytes, port 0 (DB0..DB7) first.
+ * @name LCD1602_I2C_EncodeFrames8
+ * @param cmd: The data that needs to be encoded (cmd, addr, request), only the first 10 bits are valid
+ * @param isBacklightOn: Set to 1 to turn on backlight, 0 to turn off backlight
+ * @param frames: Pointer to an array of at least 4 bytes receiving the frames
+ */
+static void LCD1602_I2C_EncodeFrames8(__UINT16_TYPE__ cmd, __UINT8_TYPE__ isBacklightOn, __UINT8_TYPE__* frames);
+
+/**
+ * @brief Encode the Enable pulse of one step of the reset sequence: the nibble on DB4..DB7 (2 PCF8574 frames), or the nibble as the higher half of an 8-bit instruction (2 PCF8575 port writes)
+ * @name LCD1602_I2C_EncodeReset
+ * @param lcd: Pointer to the display context
+ * @param nibble: The value on DB4..DB7
+ * @param frames: Pointer to an array of at least 4 bytes receiving the frames
+ * @return Return the number of frames
+ */
+static __UINT8_TYPE__ LCD1602_I2C_EncodeReset(LCD1602_I2C_t* lcd, __UINT8_TYPE__ nibble, __UINT8_TYPE__* frames);
+
+/**
+ * @brief Append a raw frame to the burst buffer. The buffer is sent first if it is full. A PCF8575 takes frames by pairs (port 0, port 1), which keeps them together as the buffer size is even.
+ * @name LCD1602_I2C_BurstAppendRaw
+ * @param lcd: Pointer to the display context
+ * @param frame: The 8-bit value to put on P0..P7 (of the port next in turn on a PCF8575)
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BurstAppendRaw(LCD1602_I2C_t* lcd, __UINT8_TYPE__ frame);
+
+/**
+ * @brief Keep the previous instruction of the burst from being overrun on a fast bus: when the next latch would come less than its execution time after the previous one, the last frame (last port write on a PCF8575) is repeated (Enable stays low) until it does not. Nothing is added at the start of a burst, LCD1602_I2C_WaitReady covers that case.
+ * @name LCD1602_I2C_BurstSpacing
+ * @param lcd: Pointer to the display context
+ * @param framesToLatch: Frames the next transfer sends up to and including the one that latches it (4 for a 4-bit transfer or a PCF8575 8-bit transfer, 2 for a raw Enable pulse)
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BurstSpacing(LCD1602_I2C_t* lcd, __UINT8_TYPE__ framesToLatch);
+
+/**
+ * @brief Start a burst. Until the matching LCD1602_I2C_BurstEnd, instructions/datas are only encoded into the burst buffer, so a whole sequence goes out as one I2C transaction.
+ * @name LCD1602_I2C_BurstBegin
+ * @param lcd: Pointer to the display context
+ */
+static void LCD1602_I2C_BurstBegin(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief End a burst started by LCD1602_I2C_BurstBegin and send the buffered frames once the outermost burst ends.
+ * @name LCD1602_I2C_BurstEnd
+ * @param lcd: Pointer to the display context
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BurstEnd(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Send every buffered frame in a single multi-byte transmit. The device is probed once per call, not once per byte.
+ * @name LCD1602_I2C_BurstCommit
+ * @param lcd: Pointer to the display context
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BurstCommit(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Get the execution time of an instruction/data from the datasheet timings.
+ * @name LCD1602_I2C_ExecTimeUs
+ * @param cmd: The instruction/data (cmd, addr, request), only the first 10 bits are valid
+ * @return Return the execution time in us
+ */
+static __UINT16_TYPE__ LCD1602_I2C_ExecTimeUs(__UINT16_TYPE__ cmd);
+
+/**
+ * @brief Wait until the LCD1602 can take the next transfer. Nothing is waited for when the previous instruction finishes before the first nibble of the next transfer would be latched (latchLeadUs of the context). With busy flag polling, the busy flag is polled instead of sleeping.
+ * @name LCD1602_I2C_WaitReady
+ * @param lcd: Pointer to the display context
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_WaitReady(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Get the current timestamp from the transport.
+ * @name LCD1602_I2C_Micros
+ * @param lcd: Pointer to the display context
+ * @return Return the timestamp in us
+ */
+static __UINT32_TYPE__ LCD1602_I2C_Micros(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Wait through the transport.
+ * @name LCD1602_I2C_DelayUs
+ * @param lcd: Pointer to the display context
+ * @param us: The time to wait in us
+ */
+static void LCD1602_I2C_DelayUs(LCD1602_I2C_t* lcd, __UINT32_TYPE__ us);
+
+/**
+ * @brief Send bytes to the PCF8574 in one I2C write transaction through the transport.
+ * @name LCD1602_I2C_BusWrite
+ * @param lcd: Pointer to the display context
+ * @param data: Pointer to the bytes to send
+ * @param length: Number of bytes
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BusWrite(LCD1602_I2C_t* lcd, const __UINT8_TYPE__* data, __UINT16_TYPE__ length);
+
+/**
+ * @brief Receive bytes from the PCF8574 in one I2C read transaction through the transport.
+ * @name LCD1602_I2C_BusRead
+ * @param lcd: Pointer to the display context
+ * @param data: Pointer to store the bytes
+ * @param length: Number of bytes
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BusRead(LCD1602_I2C_t* lcd, __UINT8_TYPE__* data, __UINT16_TYPE__ length);
+
+/**
+ * @brief Check that the PCF8574 acknowledges its address through the transport.
+ * @name LCD1602_I2C_BusProbe
+ * @param lcd: Pointer to the display context
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BusProbe(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Send the write and read messages of a busy flag/data read: as one transaction with repeated STARTs when the transport has a transfer function, otherwise one transaction per message, stopping at the first failure.
+ * @name LCD1602_I2C_BusSegments
+ * @param lcd: Pointer to the display context
+ * @param segments: Pointer to the messages, in bus order
+ * @param count: Number of messages
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BusSegments(LCD1602_I2C_t* lcd, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count);
+
+/**
+ * @brief Get the timeout of a transaction: its wire time plus LCD1602_I2C_TIMEOUT_SLACK_US, cut to what is left of the budget of the call.
+ * @name LCD1602_I2C_BusTimeout
+ * @param lcd: Pointer to the display context
+ * @param length: Number of data bytes of the transaction
+ * @param timeoutUs: Pointer to store the timeout in us
+ * @return Return the function status, LCD1602_I2C_DEADLINE if the transaction would not end in time
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_BusTimeout(LCD1602_I2C_t* lcd, __UINT16_TYPE__ length, __UINT32_TYPE__* timeoutUs);
+
+/**
+ * @brief Start the deadline of a call from its budget, unless a deadline is already running or there is no budget.
+ * @name LCD1602_I2C_DeadlineArm
+ * @param lcd: Pointer to the display context
+ * @param owner: Who ends the deadline (see deadlineOwner)
+ * @return Return 1 if the deadline was started
+ */
+static __UINT8_TYPE__ LCD1602_I2C_DeadlineArm(LCD1602_I2C_t* lcd, __UINT8_TYPE__ owner);
+
+/**
+ * @brief Record a bus failure: the LCD1602 may be out of sync (half an instruction latched, partial upload), so the recovery is started over and the state it resets is forgotten right away. Frames encoded until the recovery ends then match the display it leaves.
+ * @name LCD1602_I2C_BusFailed
+ * @param lcd: Pointer to the display context
+ */
+static void LCD1602_I2C_BusFailed(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Run the pending steps of the bus recovery (see LCD1602_I2C_Recover). A step that does not fit in the budget is left for the next call, a bus failure starts over from the recover hook.
+ * @name LCD1602_I2C_Resync
+ * @param lcd: Pointer to the display context
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Resync(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Read one register of the LCD1602 in 4 bit mode: R/~W high, data pins released (PCF8574 pins written high), then one bus read per nibble while EN is high. Behind a PCF8575 the byte is read in one Enable pulse.
+ * @name LCD1602_I2C_ReadFromLCD
+ * @param lcd: Pointer to the display context
+ * @param rs: Set to 1 to read data (DDRAM/CGRAM), 0 to read the busy flag and address counter
+ * @param value: Pointer to store the byte read
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_ReadFromLCD(LCD1602_I2C_t* lcd, __UINT8_TYPE__ rs, __UINT8_TYPE__* value);
+
+/**
+ * @brief Poll the busy flag until the LCD1602 is ready, at most LCD1602_I2C_BUSY_POLL_MAX reads.
+ * @name LCD1602_I2C_WaitBusy
+ * @param lcd: Pointer to the display context
+ * @return Return the function status, LCD1602_I2C_TIMEOUT if the busy flag never cleared
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_WaitBusy(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Read the busy flag and address counter once the LCD1602 is ready and compare the address counter with the expected one. A controller in the wrong interface mode or out of nibble sync reads back another value.
+ * @name LCD1602_I2C_WarmCheck
+ * @param lcd: Pointer to the display context
+ * @param expected: The address counter the LCD1602 should hold (DDRAM address, or CGRAM address without LCD1602_I2C_AC_CGRAM)
+ * @return Return the function status, LCD1602_I2C_ERROR if the address counter differs
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_WarmCheck(LCD1602_I2C_t* lcd, __UINT8_TYPE__ expected);
+
+/**
+ * @brief Start capturing an asynchronous call, every burst committed until LCD1602_I2C_AsyncEnd is staged in the transmit queue.
+ * @name LCD1602_I2C_AsyncBegin
+ * @param lcd: Pointer to the display context
+ * @return Return the function status, LCD1602_I2C_BUSY if another call is already being captured
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_AsyncBegin(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Finish capturing an asynchronous call. On success the staged transfers are published to the drain and the drain is started, otherwise they are discarded.
+ * @name LCD1602_I2C_AsyncEnd
+ * @param lcd: Pointer to the display context
+ * @param status: The status of the captured call
+ * @return Return the function status, LCD1602_I2C_BUSY if the queue ran out of entries
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_AsyncEnd(LCD1602_I2C_t* lcd, LCD1602_I2C_Status_t status);
+
+/**
+ * @brief Start sending the next queued transfer if the drain is idle.
+ * @name LCD1602_I2C_AsyncKick
+ * @param lcd: Pointer to the display context
+ */
+static void LCD1602_I2C_AsyncKick(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Give the bus to the next ready display of a scheduler if the bus is free. Completions that arrive during a dispatch are picked up by the same dispatch, so synchronous transports do not recurse.
+ * @name LCD1602_I2C_SchedDispatch
+ * @param sched: Pointer to the scheduler
+ */
+static void LCD1602_I2C_SchedDispatch(LCD1602_I2C_Sched_t* sched);
+
+#if LCD1602_I2C_TRACE
+/**
+ * @brief Start timing a public call, only the outermost call of a display is timed.
+ * @name LCD1602_I2C_TraceEnter
+ * @param lcd: Pointer to the display context
+ * @param api: The instrumented call
+ * @return Return the scope handed to LCD1602_I2C_TraceLeave when the call returns
+ */
+static LCD1602_I2C_TraceScope_t LCD1602_I2C_TraceEnter(LCD1602_I2C_t* lcd, LCD1602_I2C_Api_t api);
+
+/**
+ * @brief Stop timing a public call and add it to the counters of its call.
+ * @name LCD1602_I2C_TraceLeave
+ * @param scope: Pointer to the scope given by LCD1602_I2C_TraceEnter
+ */
+static void LCD1602_I2C_TraceLeave(LCD1602_I2C_TraceScope_t* scope);
+
+/**
+ * @brief Count a transaction once its transport call returned and log its bytes in the trace ring.
+ * @name LCD1602_I2C_TraceBus
+ * @param lcd: Pointer to the display context
+ * @param flags: LCD1602_I2C_TRACE_WRITE/_READ/_PROBE/_ASYNC
+ * @param data: Pointer to the bytes written or read
+ * @param length: Number of bytes, 0 for a probe
+ * @param start: Timestamp (us) at which the transaction started
+ * @param status: The status returned by the transport
+ * @return Return status unchanged
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_TraceBus(LCD1602_I2C_t* lcd, __UINT8_TYPE__ flags, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ start, LCD1602_I2C_Status_t status);
+
+/**
+ * @brief Count a transaction of several messages once its transport call returned and log the bytes of each message, the first byte of each message is marked LCD1602_I2C_TRACE_START.
+ * @name LCD1602_I2C_TraceSegments
+ * @param lcd: Pointer to the display context
+ * @param segments: Pointer to the messages
+ * @param count: Number of messages
+ * @param start: Timestamp (us) at which the transaction started
+ * @param status: The status returned by the transport
+ * @return Return status unchanged
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_TraceSegments(LCD1602_I2C_t* lcd, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count, __UINT32_TYPE__ start, LCD1602_I2C_Status_t status);
+
+/**
+ * @brief Log the bytes of one message in the trace ring, one entry per byte (one for a probe).
+ * @name LCD1602_I2C_TraceLog
+ * @param lcd: Pointer to the display context
+ * @param flags: LCD1602_I2C_TRACE_WRITE/_READ/_PROBE/_ASYNC, with LCD1602_I2C_TRACE_FAILED
+ * @param data: Pointer to the bytes written or read
+ * @param length: Number of bytes, 0 for a probe
+ * @param start: Timestamp (us) at which the transaction started
+ */
+static void LCD1602_I2C_TraceLog(LCD1602_I2C_t* lcd, __UINT8_TYPE__ flags, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ start);
+#endif
 
 
 
-// Local functions definition
 
-LCD1602_I2C_Status_t LCD1602_I2C_Clear_Display(void){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ cmd = 0b0000000001; // Clear display command
-    status = LCD1602_I2C_SendToLCD(&cmd, 1);
-    return status;
-}
 
+// Local functions definition
 
-LCD1602_I2C_Status_t LCD1602_I2C_ReturnHome(void){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ cmd = 0b0000000010; // Return home command
-    status = LCD1602_I2C_SendToLCD(&cmd, 1);
+LCD1602_I2C_Status_t LCD1602_I2C_Clear_Display(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT16_TYPE__ cmd = 0b0000000001; // Clear display command
+    status = LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
+    if(status != LCD1602_I2C_OK) return status;
+    status = LCD1602_I2C_BurstCommit(lcd); // End the burst here, the next transfer has to wait for the 1.52ms execution time
+    if(status == LCD1602_I2C_OK){
+        memset(lcd->ddram, ' ', sizeof(lcd->ddram)); // DDRAM is filled with spaces
+        lcd->ddramValid = 1;
+    }
+    lcd->marqueeText[0] = 0; // The preloaded text is gone
+    lcd->marqueeText[1] = 0;
+    lcd->ac = 0x00; // Clear display also sets I/D and cancels the shift
+    lcd->dataRegisterValid = 0;
+    lcd->displayOffset = 0;
+    lcd->increment = 1;
     return status;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_EntryModeSet(__UINT8_TYPE__ increment, __UINT8_TYPE__ shift){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ cmd = 0b0000000100; // Entry mode set command
+LCD1602_I2C_Status_t LCD1602_I2C_EntryModeSet(LCD1602_I2C_t* lcd, __UINT8_TYPE__ increment, __UINT8_TYPE__ shift){
+    __UINT16_TYPE__ cmd = 0b0000000100; // Entry mode set command
     if(increment) cmd |= (1 << 1); // Increment cursor
     if(shift) cmd |= (1 << 0); // Shift display
-    return LCD1602_I2C_SendToLCD(&cmd, 1);
+    lcd->increment = increment ? 1 : 0;
+    lcd->entryShift = shift ? 1 : 0;
+    return LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_DisplayControl(__UINT8_TYPE__ displayOn, __UINT8_TYPE__ cursorOn, __UINT8_TYPE__ blinkOn){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ cmd = 0b0000001000; // Display control command
+LCD1602_I2C_Status_t LCD1602_I2C_DisplayControl(LCD1602_I2C_t* lcd, __UINT8_TYPE__ displayOn, __UINT8_TYPE__ cursorOn, __UINT8_TYPE__ blinkOn){
+    __UINT16_TYPE__ cmd = 0b0000001000; // Display control command
     if(displayOn) cmd |= (1 << 2); // Display ON
     if(cursorOn) cmd |= (1 << 1); // Cursor ON
     if(blinkOn) cmd |= (1 << 0); // Blink ON
-    return LCD1602_I2C_SendToLCD(&cmd, 1);
+    return LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_CursorDisplayShift(__UINT8_TYPE__ shiftDisplay, __UINT8_TYPE__ shiftRight){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ cmd = 0b0000010000; // Cursor or display shift command
+LCD1602_I2C_Status_t LCD1602_I2C_CursorDisplayShift(LCD1602_I2C_t* lcd, __UINT8_TYPE__ shiftDisplay, __UINT8_TYPE__ shiftRight){
+    __UINT16_TYPE__ cmd = 0b0000010000; // Cursor or display shift command
 
     if(shiftDisplay){ // Shift display
         cmd |= (1 << 3);
         if(shiftRight){ // Shift right
             cmd |= (1 << 2);
-            g_displayOffset = (g_displayOffset + 1) >= 40 ? 0 : g_displayOffset + 1; // Wrap around at 40
+            lcd->displayOffset = (lcd->displayOffset + 1) >= LCD1602_I2C_LINE_LENGTH(lcd) ? 0 : lcd->displayOffset + 1; // Wrap around at the line length
         } else { // Shift left
-            g_displayOffset = (g_displayOffset - 1) < 0  ? 39 : g_displayOffset - 1; // Wrap around at 0
+            lcd->displayOffset = (lcd->displayOffset - 1) < 0  ? LCD1602_I2C_LINE_LENGTH(lcd) - 1 : lcd->displayOffset - 1; // Wrap around at 0
         }
     } else { // Move cursor
         if(shiftRight){ // Move right
             cmd |= (1 << 2);
-            g_cursorPos[0]++; // Update cursor column position
-            if(g_cursorPos[0] >= 40){ // If exceeds column limit
-                g_cursorPos[0] = 0;
-                g_cursorPos[1] = (g_cursorPos[1] + 1) % 2; // Move to next row
-            }
-        } else { // Move left
-            if(g_cursorPos[0] == 0){ // If at the beginning of the line
-                g_cursorPos[0] = 39;
-                g_cursorPos[1] = (g_cursorPos[1] - 1) < 0 ? 1 : g_cursorPos[1] - 1; // Move to previous row
-            } else {
-                g_cursorPos[0]--;
-            }
         }
+        lcd->dataRegisterValid = 1; // The data register is loaded from the new address
+        LCD1602_I2C_StepAddress(lcd, shiftRight); // The address counter moves like after a data write, wrapping to the other line
     }
-    return LCD1602_I2C_SendToLCD(&cmd, 1);
+    return LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_FunctionSet(__UINT8_TYPE__ numLines, __UINT8_TYPE__ fontType){
-    __UINT8_TYPE__ cmd = 0b0000100000; // Function set command
+LCD1602_I2C_Status_t LCD1602_I2C_FunctionSet(LCD1602_I2C_t* lcd, __UINT8_TYPE__ numLines, __UINT8_TYPE__ fontType){
+    __UINT16_TYPE__ cmd = 0b0000100000; // Function set command
+    if(lcd->expander == LCD1602_I2C_PCF8575) cmd |= (1 << 4); // 8-bit interface
     if(numLines) cmd |= (1 << 3); // 2 lines
     if(fontType) cmd |= (1 << 2); // 5x10 dots
-    return LCD1602_I2C_SendToLCD(&cmd, 1);
+    return LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_SetCGRAMAddress(__UINT8_TYPE__ address){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ cmd = 0b0001000000; // Set CGRAM address command
+LCD1602_I2C_Status_t LCD1602_I2C_SetCGRAMAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ address){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT16_TYPE__ cmd = 0b0001000000; // Set CGRAM address command
     cmd |= (address & 0x3F); // Set address (6 bits)
-    status = LCD1602_I2C_SendToLCD(&cmd, 1);
+    lcd->ac = LCD1602_I2C_AC_CGRAM | (address & 0x3F); // The next DDRAM access needs an address set
+    lcd->dataRegisterValid = 1;
+    status = LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
     return status;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_SetDDRAMAddress(__UINT8_TYPE__ address){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ cmd = 0b0010000000; // Set DDRAM address command
+LCD1602_I2C_Status_t LCD1602_I2C_SetDDRAMAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ address){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT16_TYPE__ cmd = 0b0010000000; // Set DDRAM address command
     cmd |= (address & 0x7F); // Set address (7 bits)
-    status = LCD1602_I2C_SendToLCD(&cmd, 1);
+    if(lcd->ac == (address & 0x7F)) return LCD1602_I2C_OK; // The address counter is already there
+    lcd->ac = address & 0x7F;
+    lcd->dataRegisterValid = 1;
+    status = LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
     return status;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_Read_BusyFlag_Address(__UINT8_TYPE__* address){
-    return HAL_OK;
+LCD1602_I2C_Status_t LCD1602_I2C_Read_BusyFlag_Address(LCD1602_I2C_t* lcd, __UINT8_TYPE__* address){
+    return LCD1602_I2C_ReadFromLCD(lcd, 0, address);
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_Write_Data(__UINT8_TYPE__ data){
-    LCD1602_I2C_Status_t status = HAL_OK;
+LCD1602_I2C_Status_t LCD1602_I2C_Write_Data(LCD1602_I2C_t* lcd, __UINT8_TYPE__ data){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
     __UINT16_TYPE__ cmd = 0b1000000000; // Data write command
     cmd |= (data & 0xFF); // Set data (8 bits)
-    status = LCD1602_I2C_SendToLCD(&cmd, 1);
+    if(lcd->ac == LCD1602_I2C_AC_UNKNOWN){
+        lcd->ddramValid = 0; // The written cell is not known, LCD1602_I2C_Flush redraws everything
+    } else if(!(lcd->ac & LCD1602_I2C_AC_CGRAM) && (lcd->twoLines ? (lcd->ac & 0x3F) < 40 : lcd->ac < 80)){
+        *LCD1602_I2C_DdramCell(lcd, lcd->ac) = (__UINT8_TYPE__)data;
+    }
+    if(lcd->entryShift && !(lcd->ac & LCD1602_I2C_AC_CGRAM)){ // The display follows the cursor, left when incrementing
+        __UINT8_TYPE__ lineLength = LCD1602_I2C_LINE_LENGTH(lcd);
+        lcd->displayOffset = lcd->increment ? (lcd->displayOffset + lineLength - 1) % lineLength : (lcd->displayOffset + 1) % lineLength;
+    }
+    LCD1602_I2C_StepAddress(lcd, lcd->increment);
+    lcd->dataRegisterValid = 0; // The data register keeps the written byte
+    status = LCD1602_I2C_SendToLCD(lcd, &cmd, lcd->backlight);
     return status;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_Read_Data(__UINT8_TYPE__* data){
-    return HAL_OK;
+LCD1602_I2C_Status_t LCD1602_I2C_Read_Data(LCD1602_I2C_t* lcd, __UINT8_TYPE__* data){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    if(!lcd->dataRegisterValid && lcd->ac != LCD1602_I2C_AC_UNKNOWN){ // A read right after a data write would return the written byte
+        __UINT8_TYPE__ ac = lcd->ac;
+        lcd->ac = LCD1602_I2C_AC_UNKNOWN; // Not skipped by LCD1602_I2C_SetDDRAMAddress
+        status = (ac & LCD1602_I2C_AC_CGRAM) ? LCD1602_I2C_SetCGRAMAddress(lcd, ac & 0x3F) : LCD1602_I2C_SetDDRAMAddress(lcd, ac);
+    }
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_BurstCommit(lcd);
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_WaitReady(lcd); // Unlike the busy flag, data can only be read once the previous instruction is done
+    if(status != LCD1602_I2C_OK) return status;
+    status = LCD1602_I2C_ReadFromLCD(lcd, 1, data);
+    if(status == LCD1602_I2C_OK){
+        LCD1602_I2C_StepAddress(lcd, lcd->increment); // Reads move the address counter too, without shifting the display
+        lcd->dataRegisterValid = 1; // Loaded from the next address
+    }
+    return status;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_Set4BitMode(void){
-    LCD1602_I2C_Status_t status = HAL_OK;
+LCD1602_I2C_Status_t LCD1602_I2C_Set4BitMode(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
     __UINT8_TYPE__ data = 0b00000000;
 
-    data |= (1 << 5); // Function set command
+    data |= PIN_DB5; // Function set command
     data |= (1 << EN_INDEX_PIN); // Toggle Enable pin
-    data |= (1 << BL_INDEX_PIN); // Toggle Backlight pin
-    status = HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)&data, 1, HAL_MAX_DELAY);
-    
-    if(status != HAL_OK) return status;
-    
+    if(lcd->backlight) data |= (1 << BL_INDEX_PIN); // Toggle Backlight pin
+    status = LCD1602_I2C_BurstSpacing(lcd, 2);
+    if(status != LCD1602_I2C_OK) return status;
+    status = LCD1602_I2C_BurstAppendRaw(lcd, data);
+    if(status != LCD1602_I2C_OK) return status;
+
     data &= ~(1 << EN_INDEX_PIN); // Toggle Enable pin
-    status = HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)&data, 1, HAL_MAX_DELAY);
+    status = LCD1602_I2C_BurstAppendRaw(lcd, data);
+    if(status != LCD1602_I2C_OK) return status;
+    lcd->lastExecUs = g_execTimeUs[5]; // Function set
 
-    return status;
+    return lcd->burstHold ? LCD1602_I2C_OK : LCD1602_I2C_BurstCommit(lcd);
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_SendToLCD(__UINT16_TYPE__* cmd, __UINT8_TYPE__ isBacklightOn){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT8_TYPE__ data = 0x00 | (isBacklightOn ? (1 << BL_INDEX_PIN) : 0x00);
+LCD1602_I2C_Status_t LCD1602_I2C_SendToLCD(LCD1602_I2C_t* lcd, __UINT16_TYPE__* cmd, __UINT8_TYPE__ isBacklightOn){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
 
-    data |= (*cmd & MSK_RS) >> (RS_INDEX_MSK - RS_INDEX_PIN); // Set RS pin
-    data |= (*cmd & MSK_RW) >> (RW_INDEX_MSK - RW_INDEX_PIN); // Set R/~W pin
-    data |= (*cmd & MSK_DB7) >> (DB7_INDEX_MSK - DB7_INDEX_PIN); // Set DB7 pin
-    data |= (*cmd & MSK_DB6) >> (DB6_INDEX_MSK - DB6_INDEX_PIN); // Set DB6 pin
-    data |= (*cmd & MSK_DB5) >> (DB5_INDEX_MSK - DB5_INDEX_PIN); // Set DB5 pin
-    data |= (*cmd & MSK_DB4) >> (DB4_INDEX_MSK - DB4_INDEX_PIN); // Set DB4 pin
-    data |= 0x01 << EN_INDEX_PIN; // Toggle Enable pin
+    status = LCD1602_I2C_BurstSpacing(lcd, 4);
+    if(status != LCD1602_I2C_OK) return status;
+    if(lcd->burstLength + 4 > LCD1602_I2C_BURST_FRAMES){ // Not enough room for another transfer
+        status = LCD1602_I2C_BurstCommit(lcd);
+        if(status != LCD1602_I2C_OK) return status;
+    }
+
+    if(lcd->expander == LCD1602_I2C_PCF8575){
+        LCD1602_I2C_EncodeFrames8(*cmd, isBacklightOn, &lcd->burstFrames[lcd->burstLength]);
+    } else {
+        LCD1602_I2C_EncodeFrames(*cmd, isBacklightOn, &lcd->burstFrames[lcd->burstLength]);
+    }
+    lcd->burstLength += 4;
+    lcd->lastExecUs = LCD1602_I2C_ExecTimeUs(*cmd);
 
-    status = HAL_I2C_IsDeviceReady(g_hi2c, PCF8574_ADDRESS, 3, HAL_MAX_DELAY);
-    if(status != HAL_OK) return status;
+    return lcd->burstHold ? LCD1602_I2C_OK : LCD1602_I2C_BurstCommit(lcd);
+}
 
-    status = HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)&data, 1, HAL_MAX_DELAY); // Send higher nibble
-    if(status != HAL_OK) return status;
 
-    data &= ~(0x01 << EN_INDEX_PIN); // Toggle Enable pin
-    status = HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)&data, 1, HAL_MAX_DELAY);
-    if(status != HAL_OK) return status;
+__UINT8_TYPE__ LCD1602_I2C_CellAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ x, __UINT8_TYPE__ y){
+    __UINT8_TYPE__ addr = 0b00000000;
 
-    data |= 0x01 << EN_INDEX_PIN; // Toggle Enable pin
-    data &= 0x0F; // Clear data bits
-    data |= (*cmd & MSK_DB3) << (DB3_INDEX_PIN - DB3_INDEX_MSK); // Set DB3 pin
-    data |= (*cmd & MSK_DB2) << (DB2_INDEX_PIN - DB2_INDEX_MSK); // Set DB2 pin
-    data |= (*cmd & MSK_DB1) << (DB1_INDEX_PIN - DB1_INDEX_MSK); // Set DB1 pin
-    data |= (*cmd & MSK_DB0) << (DB0_INDEX_PIN - DB0_INDEX_MSK); // Set DB0 pin
-    status = HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)&data, 1, HAL_MAX_DELAY); // Send lower nibble
-    if(status != HAL_OK) return status;
+    if(!lcd->twoLines){ // 1 line mode, 0x00 to 0x4F
+        return (__UINT8_TYPE__)((80 - lcd->displayOffset + x) % 80);
+    }
+    if(y == 1){
+        addr |= 0x40;
+    }
+    addr |= (0x27 - lcd->displayOffset + 1 + x) % 0x28;
+    return addr;
+}
 
-    data &= ~(0x01 << EN_INDEX_PIN); // Toggle Enable pin
-    status = HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)&data, 1, HAL_MAX_DELAY);
 
-    return status;
+__UINT8_TYPE__* LCD1602_I2C_DdramCell(LCD1602_I2C_t* lcd, __UINT8_TYPE__ address){
+    if(!lcd->twoLines) return &lcd->ddram[address / 40][address % 40]; // 0x28 to 0x4F in the second row
+    return &lcd->ddram[(address & 0x40) ? 1 : 0][address & 0x3F];
 }
 
 
+__UINT8_TYPE__ LCD1602_I2C_RowCell(LCD1602_I2C_t* lcd, int x, int y, __UINT8_TYPE__* line, __UINT8_TYPE__* end){
+    __UINT8_TYPE__ width = (lcd->rows > 2) ? lcd->columns : 40; // On 4 rows displays the next row follows on the same line
 
+    if(x < 0 || x >= width || y < 0 || y >= lcd->rows) return 0xFF;
+    *line = (lcd->rowStart[y] & 0x40) ? 1 : 0;
+    *end = (__UINT8_TYPE__)((lcd->rowStart[y] & 0x3F) + width);
+    return (__UINT8_TYPE__)((lcd->rowStart[y] & 0x3F) + x);
+}
 
 
-// Global functions definition
+void LCD1602_I2C_StepAddress(LCD1602_I2C_t* lcd, __UINT8_TYPE__ increment){
+    __UINT8_TYPE__ ac = lcd->ac;
 
-LCD1602_I2C_Status_t LCD1602_I2C_Init(I2C_HandleTypeDef* hi2c){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    __UINT16_TYPE__ cmd = 0b00000000;
-    g_hi2c = hi2c;
+    if(ac == LCD1602_I2C_AC_UNKNOWN) return;
+    if(ac & LCD1602_I2C_AC_CGRAM){
+        lcd->ac = LCD1602_I2C_AC_CGRAM | ((ac + (increment ? 1 : 0x3F)) & 0x3F);
+        return;
+    }
+    if(!lcd->twoLines){ // 1 line mode, 0x00 to 0x4F
+        lcd->ac = increment ? ((ac >= 0x4F) ? 0x00 : ac + 1) : ((ac == 0x00) ? 0x4F : ac - 1);
+        return;
+    }
+    if(increment){
+        lcd->ac = (ac == 0x27) ? 0x40 : (ac >= 0x67) ? 0x00 : ac + 1;
+    } else {
+        lcd->ac = (ac == 0x40) ? 0x27 : (ac == 0x00) ? 0x67 : ac - 1;
+    }
+}
 
-    // Wait for the LCD to power up, we can replace all HAL_Delay functions with a more precise timer if needed
-    HAL_Delay(100); // in ms
-    
-    HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)(0b00111100), 1, HAL_MAX_DELAY);
-    HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)(0b00111000), 1, HAL_MAX_DELAY);
-    HAL_Delay(7); // in ms
 
-    HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)(0b00111100), 1, HAL_MAX_DELAY);
-    HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)(0b00111000), 1, HAL_MAX_DELAY);
-    HAL_Delay(1); // in ms
+void LCD1602_I2C_GlyphForget(LCD1602_I2C_t* lcd){
+    for(__UINT8_TYPE__ i = 0; i < 8; i++){
+        lcd->glyphSlot[i] = LCD1602_I2C_GLYPH_NONE;
+    }
+}
 
-    HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)(0b00111100), 1, HAL_MAX_DELAY);
-    HAL_I2C_Master_Transmit(g_hi2c, PCF8574_ADDRESS, (unsigned char*)(0b00111000), 1, HAL_MAX_DELAY);
 
-    // Set 4-bit operation mode
-    status = LCD1602_I2C_Set4BitMode();
-    if(status != HAL_OK) return status;
+__UINT8_TYPE__ LCD1602_I2C_GlyphFind(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id){
+    for(__UINT8_TYPE__ i = 0; i < 8; i++){
+        if(lcd->glyphSlot[i] == id) return i;
+    }
+    return 0xFF;
+}
 
-    // Function set: 2 lines, 5x8 dots
-    status = LCD1602_I2C_FunctionSet(1, 0);
-    if(status != HAL_OK) return status;
 
-    // Display ON, Cursor ON, Blink OFF
-    status = LCD1602_I2C_DisplayControl(1, 1, 0);
-    if(status != HAL_OK) return status;
+LCD1602_I2C_Status_t LCD1602_I2C_GlyphLoad(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id, __UINT8_TYPE__ pinned, __UINT8_TYPE__* slot){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ found = LCD1602_I2C_GlyphFind(lcd, id);
+    __UINT8_TYPE__ rank = 7;
+
+    if(found != 0xFF){
+        lcd->glyphHits++;
+        while(lcd->glyphLru[rank] != found) rank--;
+    } else {
+        while(rank < 8 && (pinned & (1 << lcd->glyphLru[rank]))) rank--; // Least recently used character that may be replaced, wraps to 0xFF when none
+        if(rank >= 8) return LCD1602_I2C_ERROR;
+        found = lcd->glyphLru[rank];
+        lcd->glyphMisses++;
+        lcd->glyphSlot[found] = LCD1602_I2C_GLYPH_NONE; // Unknown until the upload is done
+
+        // Rows are written in the direction the address counter moves, the entry mode does not need to change
+        status = LCD1602_I2C_SetCGRAMAddress(lcd, (__UINT8_TYPE__)(found * 8 + (lcd->increment ? 0 : 7)));
+        for(__UINT8_TYPE__ i = 0; i < 8 && status == LCD1602_I2C_OK; i++){
+            status = LCD1602_I2C_Write_Data(lcd, LCD1602_I2C_GlyphBitmap(lcd, id)[lcd->increment ? i : 7 - i] & 0x1F);
+        }
+        if(status != LCD1602_I2C_OK) return status;
+        lcd->glyphSlot[found] = id;
+    }
 
-    status = LCD1602_I2C_Clear_Display();
-    if(status != HAL_OK) return status;
+    for(; rank > 0; rank--){ // Move the character to the front of the LRU order
+        lcd->glyphLru[rank] = lcd->glyphLru[rank - 1];
+    }
+    lcd->glyphLru[0] = found;
+    *slot = found;
+    return status;
+}
 
-    status = LCD1602_I2C_EntryModeSet(1, 1); // Increment cursor, with display shift
-    if(status != HAL_OK) return status;
-    // Wait for more than 39us
-    HAL_Delay(1);
 
+LCD1602_I2C_Status_t LCD1602_I2C_ShadowLoadGlyphs(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ resident = 0; // Characters that already held a glyph of the frame
+    __UINT8_TYPE__ pinned = 0;
+
+    if(lcd->glyphCount == 0 && lcd->utf8GlyphCount == 0) return LCD1602_I2C_OK; // No glyph can be in the shadow framebuffer
+    for(__UINT8_TYPE__ pass = 0; pass < 2; pass++){ // Pass 0: glyphs already in CGRAM, pass 1: uploads
+        for(__UINT8_TYPE__ y = 0; y < 2; y++){
+            for(__UINT8_TYPE__ x = 0; x < 40; x++){
+                __UINT16_TYPE__ id = lcd->shadowGlyph[y][x];
+                __UINT8_TYPE__ slot = 0xFF;
+
+                if(id == LCD1602_I2C_GLYPH_NONE) continue;
+                if(((id & LCD1602_I2C_GLYPH_UTF8) ? lcd->utf8GlyphCount : lcd->glyphCount) == 0) continue; // Table not registered again yet (LCD1602_I2C_WarmStart), the cell keeps its character
+                if(!LCD1602_I2C_GlyphBitmap(lcd, id)) return LCD1602_I2C_ERROR;
+                slot = LCD1602_I2C_GlyphFind(lcd, id);
+                if(pass == 0 && slot == 0xFF) continue;
+                if(pass == 1 && slot != 0xFF && (resident & (1 << slot))) continue; // Done in pass 0
+
+                status = LCD1602_I2C_GlyphLoad(lcd, id, pinned, &slot);
+                if(status != LCD1602_I2C_OK) return status;
+                if(pass == 0) resident |= (1 << slot);
+                pinned |= (1 << slot);
+                lcd->shadow[y][x] = slot;
+            }
+        }
+    }
     return status;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_Clear(void){
-    return LCD1602_I2C_Clear_Display();
+const __UINT8_TYPE__* LCD1602_I2C_GlyphBitmap(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id){
+    if(id & LCD1602_I2C_GLYPH_UTF8){
+        id &= (__UINT16_TYPE__)~LCD1602_I2C_GLYPH_UTF8;
+        return (id < lcd->utf8GlyphCount) ? lcd->utf8Glyphs[id].glyph : 0;
+    }
+    return (id < lcd->glyphCount) ? lcd->glyphs[id] : 0;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_MoveCursor(int x, int y){
-    __UINT8_TYPE__ addr = 0b00000000;
+__UINT8_TYPE__ LCD1602_I2C_Utf8Decode(LCD1602_I2C_Utf8Decoder_t* decoder, __UINT8_TYPE__ byte, __UINT32_TYPE__* codepoints){
+    __UINT8_TYPE__ count = 0;
+    __UINT32_TYPE__ codepoint = 0;
 
-    if(x < 0 || x >= 40 || y < 0 || y >= 2){
-        return HAL_ERROR; // Invalid position
+    if((byte & 0xC0) == 0x80){ // Continuation byte
+        if(decoder->pending == 0){
+            codepoints[0] = 0xFFFD; // Stray
+            return 1;
+        }
+        decoder->codepoint = (decoder->codepoint << 6) | (byte & 0x3F);
+        if(--decoder->pending) return 0;
+        codepoint = decoder->codepoint;
+        codepoints[0] = (codepoint < g_utf8Min[decoder->length] || codepoint > 0x10FFFF || (codepoint & 0xFFFFF800UL) == 0xD800) ? 0xFFFD : codepoint;
+        return 1;
     }
 
-    g_cursorPos[0] = (__UINT8_TYPE__)x;
-    g_cursorPos[1] = (__UINT8_TYPE__)y;
-
-    if(y == 1){
-        addr |= 0x40;
+    if(decoder->pending){
+        codepoints[count++] = 0xFFFD; // The sequence was cut short
+        decoder->pending = 0;
     }
-    addr |= (0x27 - g_displayOffset + 1 + (__UINT8_TYPE__)x) % 0x28;
-    return LCD1602_I2C_SetDDRAMAddress(addr);
+    if(byte < 0x80){
+        codepoints[count++] = byte;
+        return count;
+    }
+    decoder->length = g_utf8Length[(byte >> 3) & 0x07];
+    if(decoder->length == 0){
+        codepoints[count++] = 0xFFFD; // 0xF8..0xFF never start a sequence
+        return count;
+    }
+    decoder->pending = decoder->length;
+    decoder->codepoint = byte & (0x3F >> decoder->length); // Payload bits of the lead byte
+    return count;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_ShowChar(char c){
-    return LCD1602_I2C_Write_Data(c);
+__UINT8_TYPE__ LCD1602_I2C_Utf8Map(LCD1602_I2C_t* lcd, __UINT32_TYPE__ codepoint, __UINT16_TYPE__* cells){
+    const LCD1602_I2C_RomRange_t* range = (lcd->rom == LCD1602_I2C_ROM_A02) ? g_romA02 : g_romA00;
+    __UINT16_TYPE__ count = (lcd->rom == LCD1602_I2C_ROM_A02) ? sizeof(g_romA02) / sizeof(g_romA02[0]) : sizeof(g_romA00) / sizeof(g_romA00[0]);
+    const LCD1602_I2C_Utf8Glyph_t* glyph = lcd->utf8Glyphs;
+
+    // Last range starting at or below the codepoint, the halving step has no data dependent branch
+    while(count > 1){
+        __UINT16_TYPE__ half = count / 2;
+        range = (range[half].first <= codepoint) ? range + half : range;
+        count -= half;
+    }
+    if(codepoint >= range->first && codepoint <= range->last){
+        cells[0] = (__UINT16_TYPE__)(range->code + (codepoint - range->first));
+        return 1;
+    }
+
+    if(lcd->rom == LCD1602_I2C_ROM_A00 && codepoint - 0x30A1 < sizeof(g_kanaA00) / sizeof(g_kanaA00[0]) && g_kanaA00[codepoint - 0x30A1]){
+        cells[0] = g_kanaA00[codepoint - 0x30A1] & 0xFF;
+        cells[1] = g_kanaA00[codepoint - 0x30A1] >> 8;
+        return cells[1] ? 2 : 1;
+    }
+
+    count = lcd->utf8GlyphCount;
+    while(count > 1){
+        __UINT16_TYPE__ half = count / 2;
+        glyph = (glyph[half].codepoint <= codepoint) ? glyph + half : glyph;
+        count -= half;
+    }
+    if(lcd->utf8GlyphCount && glyph->codepoint == codepoint){
+        cells[0] = (__UINT16_TYPE__)(LCD1602_I2C_GLYPH_UTF8 | (glyph - lcd->utf8Glyphs));
+        return 1;
+    }
+
+    cells[0] = (__UINT8_TYPE__)LCD1602_I2C_UTF8_REPLACEMENT;
+    return 1;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_ShowString(char* str){
-    LCD1602_I2C_Status_t status = HAL_OK;
-    while(*str){
-        status = LCD1602_I2C_Write_Data((__UINT8_TYPE__)(*str));
-        if(status != HAL_OK) return status;
-        str++;
+LCD1602_I2C_Status_t LCD1602_I2C_MarqueeRefill(LCD1602_I2C_t* lcd, __UINT8_TYPE__ y, __UINT8_TYPE__ from, __UINT8_TYPE__ count){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT16_TYPE__ loop = (lcd->marqueeLength[y] > 40) ? lcd->marqueeLength[y] : 40; // Short text is padded to the 40 columns
+
+    for(__UINT8_TYPE__ k = from; k < from + count && status == LCD1602_I2C_OK; k++){
+        __UINT8_TYPE__ addr = LCD1602_I2C_CellAddress(lcd, k, y);
+        __UINT16_TYPE__ i = (__UINT16_TYPE__)((lcd->marqueePos[y] + k) % loop);
+        __UINT8_TYPE__ c = (i < lcd->marqueeLength[y]) ? (__UINT8_TYPE__)lcd->marqueeText[y][i] : ' ';
+
+        if(lcd->ddramValid && *LCD1602_I2C_DdramCell(lcd, addr) == c) continue; // Already there, always the case for text up to 40 characters in 2 lines mode
+
+        if(!lcd->increment || lcd->entryShift) status = LCD1602_I2C_EntryModeSet(lcd, 1, 0); // Columns are written left to right with a still display
+        if(status == LCD1602_I2C_OK) status = LCD1602_I2C_SetDDRAMAddress(lcd, addr); // Free inside a run
+        if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Write_Data(lcd, c);
     }
     return status;
 }
 
 
-LCD1602_I2C_Status_t LCD1602_I2C_ShiftDisplay(int right){
-    if(right != 0 && right != 1){
-        return HAL_ERROR; // Invalid parameter
+LCD1602_I2C_Status_t LCD1602_I2C_Format(LCD1602_I2C_Status_t (*put)(void* ctx, __UINT8_TYPE__ c), void* ctx, const char* fmt, va_list args){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+
+    while(*fmt && status == LCD1602_I2C_OK){
+        char digits[LCD1602_I2C_FORMAT_MAX + 2]; // Up to LCD1602_I2C_FORMAT_MAX digits (hex precision), or 10 digits of a 32-bit value, the decimal point and the sign
+        const char* text = digits; // Characters of the conversion
+        __UINT8_TYPE__ length = 0;
+        __UINT8_TYPE__ leftAlign = 0;
+        __UINT8_TYPE__ zeroPad = 0;
+        __UINT8_TYPE__ width = 0;
+        __INT8_TYPE__ precision = -1;
+        __UINT8_TYPE__ signLength = 0; // Leading sign kept before the zero padding
+        __UINT8_TYPE__ isLong = 0;
+
+        if(*fmt != '%'){
+            status = put(ctx, (__UINT8_TYPE__)(*fmt++));
+            continue;
+        }
+        fmt++;
+
+        for(;; fmt++){ // Flags
+            if(*fmt == '-') leftAlign = 1;
+            else if(*fmt == '0') zeroPad = 1;
+            else break;
+        }
+        while(*fmt >= '0' && *fmt <= '9'){ // Saturated, wider than a line is never needed
+            __UINT16_TYPE__ value = width * 10 + (*fmt++ - '0');
+            width = (value > LCD1602_I2C_FORMAT_MAX) ? LCD1602_I2C_FORMAT_MAX : (__UINT8_TYPE__)value;
+        }
+        if(*fmt == '.'){
+            precision = 0;
+            fmt++;
+            while(*fmt >= '0' && *fmt <= '9'){
+                __UINT16_TYPE__ value = precision * 10 + (*fmt++ - '0');
+                precision = (value > LCD1602_I2C_FORMAT_MAX) ? LCD1602_I2C_FORMAT_MAX : (__INT8_TYPE__)value;
+            }
+        }
+        if(*fmt == 'l'){
+            isLong = 1;
+            fmt++;
+        }
+
+        switch(*fmt){
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X': {
+                __UINT32_TYPE__ value = 0;
+                __UINT8_TYPE__ negative = 0;
+                __UINT8_TYPE__ base = (*fmt == 'x' || *fmt == 'X') ? 16 : 10;
+                const char* hex = (*fmt == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
+                __UINT8_TYPE__ pos = sizeof(digits);
+                __INT8_TYPE__ minDigits = 1;
+                __INT8_TYPE__ point = (precision > 9) ? 9 : precision; // Fixed point decimals, a 32-bit value has 10 digits
+
+                if(*fmt == 'd' || *fmt == 'i'){
+                    long v = isLong ? va_arg(args, long) : va_arg(args, int);
+                    negative = (v < 0);
+                    value = negative ? (__UINT32_TYPE__)0 - (__UINT32_TYPE__)v : (__UINT32_TYPE__)v; // Only the lower 32 bits are shown
+                } else {
+                    value = isLong ? (__UINT32_TYPE__)va_arg(args, unsigned long) : (__UINT32_TYPE__)va_arg(args, unsigned int);
+                }
+                if(base == 16 && precision > 0) minDigits = precision; // Minimum number of digits, like printf
+                if(base == 10 && point > 0) minDigits = point + 1; // Fixed point: at least one digit before the point
+
+                // Digits are produced from the right
+                for(__INT8_TYPE__ n = 0; value || n < minDigits; n++){
+                    if(base == 10 && point > 0 && n == point) digits[--pos] = '.';
+                    digits[--pos] = hex[value % base];
+                    value /= base;
+                }
+                if(negative){
+                    digits[--pos] = '-';
+                    signLength = 1;
+                }
+                text = &digits[pos];
+                length = (__UINT8_TYPE__)(sizeof(digits) - pos);
+                break;
+            }
+            case 'c':
+                digits[0] = (char)va_arg(args, int);
+                length = 1;
+                zeroPad = 0;
+                break;
+            case 's':
+                text = va_arg(args, const char*);
+                if(!text) text = "";
+                while(text[length] && length < ((precision < 0) ? LCD1602_I2C_FORMAT_MAX : precision)) length++; // Longer strings are cut at one DDRAM line
+                zeroPad = 0;
+                break;
+            case '%':
+                digits[0] = '%';
+                length = 1;
+                zeroPad = 0;
+                break;
+            default:
+                return LCD1602_I2C_ERROR; // Unknown conversion, or the format ends after '%'
+        }
+        fmt++;
+
+        // Padding: zeros go between the sign and the digits, spaces before or after the whole conversion
+        __UINT8_TYPE__ pad = (width > length) ? width - length : 0;
+        if(!leftAlign && !zeroPad){
+            for(; pad > 0 && status == LCD1602_I2C_OK; pad--) status = put(ctx, ' ');
+        }
+        for(__UINT8_TYPE__ i = 0; i < signLength && status == LCD1602_I2C_OK; i++) status = put(ctx, (__UINT8_TYPE__)text[i]);
+        if(!leftAlign && zeroPad){
+            for(; pad > 0 && status == LCD1602_I2C_OK; pad--) status = put(ctx, '0');
+        }
+        for(__UINT8_TYPE__ i = signLength; i < length && status == LCD1602_I2C_OK; i++) status = put(ctx, (__UINT8_TYPE__)text[i]);
+        for(; pad > 0 && status == LCD1602_I2C_OK; pad--) status = put(ctx, ' ');
+    }
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_PutDisplay(void* ctx, __UINT8_TYPE__ c){
+    return LCD1602_I2C_Write_Data((LCD1602_I2C_t*)ctx, c);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_PutShadow(void* ctx, __UINT8_TYPE__ c){
+    LCD1602_I2C_ShadowCursor_t* cursor = (LCD1602_I2C_ShadowCursor_t*)ctx;
+
+    if(cursor->x < cursor->end){
+        cursor->lcd->shadowGlyph[cursor->y][cursor->x] = LCD1602_I2C_GLYPH_NONE;
+        cursor->lcd->shadow[cursor->y][cursor->x++] = c;
+    }
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_PutRegion(void* ctx, __UINT8_TYPE__ c){
+    LCD1602_I2C_RegionCursor_t* cursor = (LCD1602_I2C_RegionCursor_t*)ctx;
+
+    if(cursor->x < cursor->region->width){
+        cursor->region->text[cursor->x++] = c;
+    }
+    return LCD1602_I2C_OK;
+}
+
+
+void LCD1602_I2C_RegionPostBegin(LCD1602_I2C_Region_t* region){
+    region->sequence = region->sequence + 1; // Only this producer writes the sequence
+    LCD1602_I2C_MEMORY_BARRIER(); // Odd before the first character changes
+}
+
+
+void LCD1602_I2C_RegionPostEnd(LCD1602_I2C_Region_t* region, __UINT8_TYPE__ length){
+    while(length < region->width){
+        region->text[length++] = ' ';
+    }
+    LCD1602_I2C_MEMORY_BARRIER(); // Every character is written before the sequence turns even
+    region->sequence = region->sequence + 1;
+}
+
+
+void LCD1602_I2C_RegionCollect(LCD1602_I2C_t* lcd){
+    for(__UINT8_TYPE__ i = 0; i < lcd->regionCount; i++){
+        LCD1602_I2C_Region_t* region = lcd->regions[i];
+        __UINT32_TYPE__ sequence = region->sequence;
+        __UINT8_TYPE__ text[LCD1602_I2C_REGION_CHARS];
+
+        if(sequence == region->applied || (sequence & 1)) continue; // Nothing new, or a post is in progress
+        LCD1602_I2C_MEMORY_BARRIER();
+        for(__UINT8_TYPE__ x = 0; x < region->width; x++){
+            text[x] = region->text[x];
+        }
+        LCD1602_I2C_MEMORY_BARRIER();
+        if(region->sequence != sequence) continue; // Posted again while being copied, the copy may be torn
+
+        for(__UINT8_TYPE__ x = 0; x < region->width; x++){
+            lcd->shadowGlyph[region->y][region->x + x] = LCD1602_I2C_GLYPH_NONE;
+            lcd->shadow[region->y][region->x + x] = text[x];
+        }
+        region->applied = sequence;
+        lcd->refreshPending = 1;
+    }
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_RefreshFrame(LCD1602_I2C_t* lcd, LCD1602_I2C_Status_t (*flush)(LCD1602_I2C_t* lcd)){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT32_TYPE__ now = LCD1602_I2C_Micros(lcd);
+
+    if(lcd->framePeriodUs && now - lcd->lastFrame < lcd->framePeriodUs){
+        return LCD1602_I2C_OK; // Too early, the posts keep collapsing in the regions
+    }
+    LCD1602_I2C_RegionCollect(lcd);
+    if(!lcd->refreshPending) return LCD1602_I2C_OK;
+
+    status = flush(lcd);
+    if(status != LCD1602_I2C_BUSY) lcd->lastFrame = now; // Nothing was sent on BUSY, the next call tries again
+    if(status == LCD1602_I2C_OK) lcd->refreshPending = 0;
+    return status;
+}
+
+
+void LCD1602_I2C_EncodeFrames(__UINT16_TYPE__ cmd, __UINT8_TYPE__ isBacklightOn, __UINT8_TYPE__* frames){
+    __UINT16_TYPE__ entry = g_frameTable[(cmd & MSK_RS) ? 1 : 0][cmd & 0xFF];
+    __UINT8_TYPE__ ctrl = (isBacklightOn ? PIN_BL : 0x00) | ((cmd & MSK_RW) ? PIN_RW : 0x00);
+    __UINT8_TYPE__ data = (__UINT8_TYPE__)(entry & 0xFF) | ctrl;
+
+    frames[0] = data | PIN_EN; // Higher nibble, Enable high
+    frames[1] = data; // Enable low, the HD44780U latches the higher nibble
+
+    data = (__UINT8_TYPE__)(entry >> 8) | ctrl;
+    frames[2] = data | PIN_EN; // Lower nibble, Enable high
+    frames[3] = data; // Enable low, the HD44780U latches the lower nibble
+}
+
+
+void LCD1602_I2C_EncodeFrames8(__UINT16_TYPE__ cmd, __UINT8_TYPE__ isBacklightOn, __UINT8_TYPE__* frames){
+    __UINT8_TYPE__ ctrl = PCF8575_PINS_UNUSED | (isBacklightOn ? PCF8575_PIN_BL : 0x00) | ((cmd & MSK_RS) ? PCF8575_PIN_RS : 0x00) | ((cmd & MSK_RW) ? PCF8575_PIN_RW : 0x00);
+
+    frames[0] = (__UINT8_TYPE__)(cmd & 0xFF); // Port 0 is updated first, DB0..DB7 are stable before Enable rises
+    frames[1] = ctrl | PCF8575_PIN_EN;
+    frames[2] = (__UINT8_TYPE__)(cmd & 0xFF);
+    frames[3] = ctrl; // Enable low, the HD44780U latches the whole byte
+}
+
+
+__UINT8_TYPE__ LCD1602_I2C_EncodeReset(LCD1602_I2C_t* lcd, __UINT8_TYPE__ nibble, __UINT8_TYPE__* frames){
+    if(lcd->expander == LCD1602_I2C_PCF8575){
+        LCD1602_I2C_EncodeFrames8((__UINT16_TYPE__)(nibble << 4), lcd->backlight, frames); // DB0..DB3 low, as with DB0..DB3 unconnected
+        return 4;
+    }
+    frames[0] = LCD1602_I2C_NIBBLE_PINS(nibble) | (lcd->backlight ? PIN_BL : 0x00) | PIN_EN;
+    frames[1] = frames[0] & ~PIN_EN;
+    return 2;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BurstAppendRaw(LCD1602_I2C_t* lcd, __UINT8_TYPE__ frame){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+
+    if(lcd->burstLength >= LCD1602_I2C_BURST_FRAMES){
+        status = LCD1602_I2C_BurstCommit(lcd);
+        if(status != LCD1602_I2C_OK) return status;
+    }
+    lcd->burstFrames[lcd->burstLength++] = frame;
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BurstSpacing(LCD1602_I2C_t* lcd, __UINT8_TYPE__ framesToLatch){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT32_TYPE__ needed = ((__UINT32_TYPE__)lcd->lastExecUs * lcd->busKhz + 8999) / 9000; // Frames (8 bits + acknowledge each) covering the execution time
+    __UINT8_TYPE__ pair = (lcd->expander == LCD1602_I2C_PCF8575) ? 1 : 0;
+    __UINT8_TYPE__ idle[2];
+
+    if(lcd->burstLength == 0) return LCD1602_I2C_OK;
+    idle[0] = lcd->burstFrames[lcd->burstLength - 1 - pair]; // Last value of each PCF8575 port, or twice the last PCF8574 frame
+    idle[1] = lcd->burstFrames[lcd->burstLength - 1];
+    if(pair && needed > framesToLatch && ((needed - framesToLatch) & 1)) needed++; // Whole port writes only
+    for(__UINT32_TYPE__ i = framesToLatch; i < needed && status == LCD1602_I2C_OK; i++){
+        status = LCD1602_I2C_BurstAppendRaw(lcd, idle[(i - framesToLatch) & 1]);
+    }
+    return status;
+}
+
+
+void LCD1602_I2C_BurstBegin(LCD1602_I2C_t* lcd){
+    if(lcd->burstHold++ == 0) LCD1602_I2C_DeadlineArm(lcd, 1); // The budget covers the whole call
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BurstEnd(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+
+    if(lcd->burstHold > 0) lcd->burstHold--;
+    if(lcd->burstHold) return LCD1602_I2C_OK;
+    status = LCD1602_I2C_BurstCommit(lcd);
+    if(lcd->deadlineOwner == 1) lcd->deadlineOwner = 0;
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BurstCommit(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT16_TYPE__ length = lcd->burstLength;
+    __UINT8_TYPE__ armed = 0;
+    __UINT8_TYPE__ inSync = 0;
+
+    if(length == 0) return LCD1602_I2C_OK;
+    lcd->burstLength = 0; // Drop the frames even on failure, a partial sequence must not be replayed later
+
+    if(lcd->asyncCapture){ // Stage the frames in the transmit queue, split over as many entries as needed
+        for(__UINT16_TYPE__ i = 0; i < length; i += LCD1602_I2C_ASYNC_ENTRY_FRAMES){
+            __UINT8_TYPE__ next = (lcd->asyncStage + 1) % LCD1602_I2C_ASYNC_DEPTH;
+            __UINT16_TYPE__ chunk = (length - i) < LCD1602_I2C_ASYNC_ENTRY_FRAMES ? (length - i) : LCD1602_I2C_ASYNC_ENTRY_FRAMES;
+            if(next == lcd->asyncTail) return LCD1602_I2C_BUSY; // Queue full
+
+            memcpy(lcd->asyncQueue[lcd->asyncStage].frames, &lcd->burstFrames[i], chunk);
+            lcd->asyncQueue[lcd->asyncStage].length = chunk;
+            lcd->asyncQueue[lcd->asyncStage].settleUs = (i + chunk < length || lcd->lastExecUs <= lcd->latchLeadUs) ? 0 : lcd->lastExecUs - lcd->latchLeadUs;
+            lcd->asyncQueue[lcd->asyncStage].isLast = 0;
+            lcd->asyncStage = next;
+        }
+        return LCD1602_I2C_OK;
+    }
+
+    if(lcd->asyncState != LCD1602_I2C_ASYNC_IDLE || lcd->asyncHead != lcd->asyncTail){
+        status = LCD1602_I2C_BUSY; // The bus is owned by the asynchronous drain
+    }
+
+    armed = LCD1602_I2C_DeadlineArm(lcd, 2);
+    inSync = (lcd->recoverStep == 0);
+    if(status == LCD1602_I2C_OK && !inSync) status = LCD1602_I2C_Resync(lcd); // Finish the recovery of an earlier failure first, the frames were encoded for the state it leaves
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_WaitReady(lcd); // The last instruction of the previous burst may still be executing
+    if(status == LCD1602_I2C_OK){
+        status = LCD1602_I2C_BusWrite(lcd, lcd->burstFrames, length); // No probe first, a missing device NACKs the address byte of the write
+        lcd->readyAt = LCD1602_I2C_Micros(lcd) + lcd->lastExecUs + lcd->transport->timeResolutionUs; // The last instruction starts executing once the transmit ends
+        lcd->busyPending = lcd->busyPolling && (lcd->lastExecUs > lcd->latchLeadUs);
+    }
+    if(status != LCD1602_I2C_OK){ // The model already counts the dropped frames, and part of them may have been executed
+        lcd->ac = LCD1602_I2C_AC_UNKNOWN;
+        lcd->ddramValid = 0;
+        LCD1602_I2C_GlyphForget(lcd);
+    }
+    if(status != LCD1602_I2C_OK && status != LCD1602_I2C_BUSY && status != LCD1602_I2C_DEADLINE){ // Nothing was sent on BUSY/DEADLINE, anything else may have left the LCD1602 out of sync
+        LCD1602_I2C_BusFailed(lcd);
+        if(inSync) LCD1602_I2C_Resync(lcd); // Recover right away with what is left of the budget, the call still reports the failure
+    }
+    if(armed) lcd->deadlineOwner = 0;
+    return status;
+}
+
+
+__UINT16_TYPE__ LCD1602_I2C_ExecTimeUs(__UINT16_TYPE__ cmd){
+    __UINT8_TYPE__ bit = 7;
+
+    if(cmd & MSK_RS) return LCD1602_I2C_DATA_EXEC_US;
+    while(bit > 0 && !(cmd & (1 << bit))) bit--; // Highest bit set selects the instruction
+    return g_execTimeUs[bit];
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_WaitReady(LCD1602_I2C_t* lcd){
+    __UINT32_TYPE__ now = LCD1602_I2C_Micros(lcd);
+    __INT32_TYPE__ remaining = (__INT32_TYPE__)(lcd->readyAt - now) - lcd->latchLeadUs; // Signed difference survives the timestamp wrap-around
+
+    if(remaining <= 0){
+        lcd->busyPending = 0;
+        return LCD1602_I2C_OK;
+    }
+    if(lcd->busyPending){
+        return LCD1602_I2C_WaitBusy(lcd); // Every read is checked against the deadline
+    }
+    if(lcd->deadlineOwner && (__INT32_TYPE__)(lcd->deadline - now) < remaining){
+        return LCD1602_I2C_DEADLINE; // Sleeping would overrun the budget, a later call waits for the rest
+    }
+    LCD1602_I2C_DelayUs(lcd, (__UINT32_TYPE__)remaining);
+    return LCD1602_I2C_OK;
+}
+
+
+__UINT32_TYPE__ LCD1602_I2C_Micros(LCD1602_I2C_t* lcd){
+    return lcd->transport->micros(lcd->bus);
+}
+
+
+void LCD1602_I2C_DelayUs(LCD1602_I2C_t* lcd, __UINT32_TYPE__ us){
+    lcd->transport->delayUs(lcd->bus, us);
+    LCD1602_I2C_TRACE_COUNT(lcd, delayUs, us);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BusWrite(LCD1602_I2C_t* lcd, const __UINT8_TYPE__* data, __UINT16_TYPE__ length){
+    __UINT32_TYPE__ timeoutUs = 0;
+    LCD1602_I2C_Status_t status = LCD1602_I2C_BusTimeout(lcd, length, &timeoutUs);
+    if(status != LCD1602_I2C_OK) return status;
+    lcd->writing = 1;
+    status = LCD1602_I2C_TRACE_BUS(lcd, LCD1602_I2C_TRACE_WRITE, data, length, lcd->transport->write(lcd->bus, lcd->address, data, length, timeoutUs));
+    lcd->writing = 0;
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BusRead(LCD1602_I2C_t* lcd, __UINT8_TYPE__* data, __UINT16_TYPE__ length){
+    __UINT32_TYPE__ timeoutUs = 0;
+    LCD1602_I2C_Status_t status = LCD1602_I2C_BusTimeout(lcd, length, &timeoutUs);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_TRACE_BUS(lcd, LCD1602_I2C_TRACE_READ, data, length, lcd->transport->read(lcd->bus, lcd->address, data, length, timeoutUs));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BusProbe(LCD1602_I2C_t* lcd){
+    __UINT32_TYPE__ timeoutUs = 0;
+    LCD1602_I2C_Status_t status = LCD1602_I2C_BusTimeout(lcd, 0, &timeoutUs);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_TRACE_BUS(lcd, LCD1602_I2C_TRACE_PROBE, 0, 0, lcd->transport->probe(lcd->bus, lcd->address, timeoutUs));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BusSegments(LCD1602_I2C_t* lcd, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT32_TYPE__ timeoutUs = 0;
+    __UINT16_TYPE__ length = count - 1; // Address byte after each repeated START
+
+    if(!lcd->transport->transfer){
+        for(__UINT8_TYPE__ i = 0; i < count && status == LCD1602_I2C_OK; i++){
+            status = segments[i].read ? LCD1602_I2C_BusRead(lcd, segments[i].data, segments[i].length) : LCD1602_I2C_BusWrite(lcd, segments[i].data, segments[i].length);
+        }
+        return status;
+    }
+
+    for(__UINT8_TYPE__ i = 0; i < count; i++) length += segments[i].length;
+    status = LCD1602_I2C_BusTimeout(lcd, length, &timeoutUs);
+    if(status != LCD1602_I2C_OK) return status;
+    lcd->writing = 1;
+    status = LCD1602_I2C_TRACE_SEGMENTS(lcd, segments, count, lcd->transport->transfer(lcd->bus, lcd->address, segments, count, timeoutUs));
+    lcd->writing = 0;
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_BusTimeout(LCD1602_I2C_t* lcd, __UINT16_TYPE__ length, __UINT32_TYPE__* timeoutUs){
+    __UINT32_TYPE__ wireUs = ((__UINT32_TYPE__)length + 1) * 9000 / lcd->busKhz + 1; // Address byte included, 9 clocks per byte, START/STOP in the rounding
+    __INT32_TYPE__ remaining = 0;
+
+    *timeoutUs = wireUs + LCD1602_I2C_TIMEOUT_SLACK_US;
+    if(!lcd->deadlineOwner) return LCD1602_I2C_OK;
+    remaining = (__INT32_TYPE__)(lcd->deadline - LCD1602_I2C_Micros(lcd));
+    if(remaining < (__INT32_TYPE__)wireUs) return LCD1602_I2C_DEADLINE;
+    if((__UINT32_TYPE__)remaining < *timeoutUs) *timeoutUs = (__UINT32_TYPE__)remaining;
+    return LCD1602_I2C_OK;
+}
+
+
+__UINT8_TYPE__ LCD1602_I2C_DeadlineArm(LCD1602_I2C_t* lcd, __UINT8_TYPE__ owner){
+    if(!lcd->budgetUs || lcd->deadlineOwner) return 0;
+    lcd->deadline = LCD1602_I2C_Micros(lcd) + lcd->budgetUs;
+    lcd->deadlineOwner = owner;
+    return 1;
+}
+
+
+void LCD1602_I2C_BusFailed(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_TRACE_COUNT(lcd, retries, 1);
+    lcd->recoverStep = 1;
+    lcd->ac = LCD1602_I2C_AC_UNKNOWN;
+    lcd->displayOffset = 0; // Return home of the resynchronization
+    lcd->ddramValid = 0;
+    LCD1602_I2C_GlyphForget(lcd);
+    lcd->marqueeText[0] = 0; // The scrolled text is lost with the display shift
+    lcd->marqueeText[1] = 0;
+    lcd->refreshPending = 1; // LCD1602_I2C_Refresh redraws the shadow framebuffer once resynchronized
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Resync(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ frames[4];
+
+    /*
+     * Steps, one transaction each so a step that does not fit in the budget is resumed by the next call
+     * 1: recover hook and probe
+     * 2..5: nibbles 0x3, 0x3, 0x3, 0x2, the LCD1602 ends in 4-bit mode whether it was waiting for a higher nibble, a lower nibble or in 8-bit mode (0x3 four times with a PCF8575, ending in 8-bit mode)
+     * 6..9: function set, display control, entry mode set, return home
+     * 10: wait for the return home, the asynchronous drain does not look at readyAt
+     */
+    while(status == LCD1602_I2C_OK && lcd->recoverStep){
+        __UINT8_TYPE__ step = lcd->recoverStep;
+        __UINT16_TYPE__ cmd = 0b0000000000;
+
+        if(step == 1){
+            lcd->busyPending = 0; // The busy flag can not be trusted before the resynchronization
+            if(lcd->transport->recover) status = lcd->transport->recover(lcd->bus);
+            if(status == LCD1602_I2C_OK) status = LCD1602_I2C_BusProbe(lcd);
+        } else {
+            status = LCD1602_I2C_WaitReady(lcd);
+        }
+        if(status == LCD1602_I2C_OK && step >= 2 && step <= 5){
+            __UINT8_TYPE__ length = LCD1602_I2C_EncodeReset(lcd, (step < 5 || lcd->expander == LCD1602_I2C_PCF8575) ? 0x3 : 0x2, frames); // A PCF8575 stays in 8-bit mode, a fourth 8-bit function set
+            status = LCD1602_I2C_BusWrite(lcd, frames, length);
+            lcd->readyAt = LCD1602_I2C_Micros(lcd) + ((step == 2) ? 4100 : (step == 3) ? 100 : g_execTimeUs[5]) + lcd->transport->timeResolutionUs; // Same pauses as the power-on sequence, the first nibble may also end a return home
+        } else if(status == LCD1602_I2C_OK && step >= 6 && step <= 9){
+            if(step == 6) cmd = ((lcd->expander == LCD1602_I2C_PCF8575) ? 0b0000110000 : 0b0000100000) | (lcd->twoLines << 3); // Function set: 8-bit/4-bit, lines of the geometry, 5x8 dots
+            if(step == 7) cmd = 0b0000001110; // Display ON, Cursor ON, Blink OFF
+            if(step == 8) cmd = 0b0000000100 | (lcd->increment << 1) | lcd->entryShift; // Entry mode of the context
+            if(step == 9) cmd = 0b0000000010; // Return home, cancels the display shift
+            if(lcd->expander == LCD1602_I2C_PCF8575){
+                LCD1602_I2C_EncodeFrames8(cmd, lcd->backlight, frames);
+            } else {
+                LCD1602_I2C_EncodeFrames(cmd, lcd->backlight, frames);
+            }
+            status = LCD1602_I2C_BusWrite(lcd, frames, 4);
+            lcd->readyAt = LCD1602_I2C_Micros(lcd) + LCD1602_I2C_ExecTimeUs(cmd) + lcd->transport->timeResolutionUs;
+        }
+
+        if(status == LCD1602_I2C_OK){
+            lcd->recoverStep = (step == 10) ? 0 : step + 1;
+        } else if(status != LCD1602_I2C_DEADLINE){
+            lcd->recoverStep = 1; // Failed again, start over from the bus recovery
+            LCD1602_I2C_TRACE_COUNT(lcd, retries, 1);
+        }
+    }
+    if(status == LCD1602_I2C_OK){
+        lcd->ac = 0x00;
+        lcd->dataRegisterValid = 0;
+    }
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ReadFromLCD(LCD1602_I2C_t* lcd, __UINT8_TYPE__ rs, __UINT8_TYPE__* value){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ base = (lcd->backlight ? PIN_BL : 0x00) | PIN_RW | PIN_DB4 | PIN_DB5 | PIN_DB6 | PIN_DB7 | (rs ? PIN_RS : 0x00); // Data pins high so the LCD can drive them
+    __UINT8_TYPE__ frames[2];
+    __UINT8_TYPE__ pins[2];
+    __UINT32_TYPE__ timeoutUs = 0;
+
+    if(lcd->asyncCapture) return LCD1602_I2C_BUSY; // Reads can not be queued
+    status = LCD1602_I2C_BurstCommit(lcd); // Everything written before must reach the LCD first
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_BusTimeout(lcd, (lcd->expander == LCD1602_I2C_PCF8575) ? 10 : 11, &timeoutUs); // The whole read must fit in the budget: 5 transactions, 12 bytes with the addresses (3 transactions, 11 bytes with a PCF8575)
+    if(status != LCD1602_I2C_OK) return status;
+
+    if(lcd->expander == LCD1602_I2C_PCF8575){ // The whole byte in one Enable pulse
+        __UINT8_TYPE__ ports[4];
+        __UINT8_TYPE__ ctrl = PCF8575_PINS_UNUSED | (lcd->backlight ? PCF8575_PIN_BL : 0x00) | PCF8575_PIN_RW | (rs ? PCF8575_PIN_RS : 0x00);
+        ports[0] = 0xFF; // DB0..DB7 released
+        ports[1] = ctrl; // R/~W and RS settle before the Enable pulse
+        ports[2] = 0xFF;
+        ports[3] = ctrl | PCF8575_PIN_EN; // The LCD drives DB0..DB7 while Enable is high
+        const LCD1602_I2C_Segment_t segments[3] = {
+            {ports, 4, 0},
+            {pins, 2, 1},
+            {ports, 2, 0} // Enable low, ends the read
+        };
+        status = LCD1602_I2C_BusSegments(lcd, segments, 3);
+        if(status != LCD1602_I2C_OK){
+            LCD1602_I2C_BusFailed(lcd);
+            return status;
+        }
+        *value = pins[0]; // Port 0 is read first
+        return status;
+    }
+
+    frames[0] = base; // R/~W and RS settle before the Enable pulse
+    frames[1] = base | PIN_EN; // The LCD drives the nibble while Enable is high
+    const LCD1602_I2C_Segment_t segments[5] = {
+        {frames, 2, 0},
+        {&pins[0], 1, 1}, // Higher nibble
+        {frames, 2, 0},
+        {&pins[1], 1, 1}, // Lower nibble
+        {&base, 1, 0} // Enable low, ends the second nibble
+    };
+    status = LCD1602_I2C_BusSegments(lcd, segments, 5);
+    if(status != LCD1602_I2C_OK){ // The LCD1602 may be left in the middle of the read
+        LCD1602_I2C_BusFailed(lcd);
+        return status;
+    }
+
+    *value = 0x00;
+    for(__UINT8_TYPE__ i = 0; i < 2; i++){
+        __UINT8_TYPE__ shift = (i == 0) ? 4 : 0; // Higher nibble first
+        *value |= ((pins[i] & PIN_DB4) ? 0x1 : 0x0) << shift;
+        *value |= ((pins[i] & PIN_DB5) ? 0x2 : 0x0) << shift;
+        *value |= ((pins[i] & PIN_DB6) ? 0x4 : 0x0) << shift;
+        *value |= ((pins[i] & PIN_DB7) ? 0x8 : 0x0) << shift;
+    }
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_WaitBusy(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ flagAddress = 0x00;
+
+    for(__UINT16_TYPE__ i = 0; i < LCD1602_I2C_BUSY_POLL_MAX; i++){
+        status = LCD1602_I2C_Read_BusyFlag_Address(lcd, &flagAddress);
+        if(status != LCD1602_I2C_OK) return status;
+        if(!(flagAddress & 0x80)){
+            lcd->busyPending = 0;
+            return LCD1602_I2C_OK;
+        }
+        LCD1602_I2C_TRACE_COUNT(lcd, retries, 1);
+    }
+    return LCD1602_I2C_TIMEOUT;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_WarmCheck(LCD1602_I2C_t* lcd, __UINT8_TYPE__ expected){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ flagAddress = 0x80;
+
+    for(__UINT16_TYPE__ i = 0; i < LCD1602_I2C_BUSY_POLL_MAX && (flagAddress & 0x80); i++){ // An instruction sent before the reset may still be executing
+        status = LCD1602_I2C_Read_BusyFlag_Address(lcd, &flagAddress);
+        if(status != LCD1602_I2C_OK) return status;
+    }
+    if(flagAddress & 0x80) return LCD1602_I2C_TIMEOUT;
+    return ((flagAddress & 0x7F) == expected) ? LCD1602_I2C_OK : LCD1602_I2C_ERROR;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_AsyncBegin(LCD1602_I2C_t* lcd){
+    if(lcd->asyncCapture || lcd->burstHold) return LCD1602_I2C_BUSY; // Not re-entrant, and a synchronous burst is being built
+    lcd->asyncCapture = 1;
+    lcd->asyncStage = lcd->asyncHead;
+    lcd->asyncSaved[0] = lcd->ac; // The model moves while the call is encoded, put it back if the call is not queued
+    lcd->asyncSaved[1] = lcd->displayOffset;
+    lcd->asyncSaved[2] = lcd->increment;
+    lcd->asyncSaved[3] = lcd->entryShift;
+    memcpy(lcd->asyncSavedGlyphSlot, lcd->glyphSlot, sizeof(lcd->glyphSlot));
+    memcpy(lcd->asyncSavedGlyphLru, lcd->glyphLru, sizeof(lcd->glyphLru));
+    memcpy(lcd->asyncSavedMarqueeText, lcd->marqueeText, sizeof(lcd->marqueeText));
+    memcpy(lcd->asyncSavedMarqueePos, lcd->marqueePos, sizeof(lcd->marqueePos));
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_AsyncEnd(LCD1602_I2C_t* lcd, LCD1602_I2C_Status_t status){
+    lcd->asyncCapture = 0;
+    if(status != LCD1602_I2C_OK || lcd->asyncStage == lcd->asyncHead){ // Failed, or nothing to send
+        lcd->burstLength = 0;
+        lcd->asyncStage = lcd->asyncHead; // Discard whatever was staged, the call is all or nothing
+        if(status != LCD1602_I2C_OK){
+            lcd->ac = lcd->asyncSaved[0];
+            lcd->dataRegisterValid = 0;
+            lcd->displayOffset = lcd->asyncSaved[1];
+            lcd->increment = lcd->asyncSaved[2];
+            lcd->entryShift = lcd->asyncSaved[3];
+            memcpy(lcd->glyphSlot, lcd->asyncSavedGlyphSlot, sizeof(lcd->glyphSlot)); // Glyphs uploaded by the call never reached CGRAM
+            memcpy(lcd->glyphLru, lcd->asyncSavedGlyphLru, sizeof(lcd->glyphLru));
+            memcpy(lcd->marqueeText, lcd->asyncSavedMarqueeText, sizeof(lcd->marqueeText));
+            memcpy(lcd->marqueePos, lcd->asyncSavedMarqueePos, sizeof(lcd->marqueePos));
+            lcd->ddramValid = 0; // Cells written by the call are in the model but not on the LCD1602
+        }
+        return status;
+    }
+
+    lcd->asyncQueue[(lcd->asyncStage + LCD1602_I2C_ASYNC_DEPTH - 1) % LCD1602_I2C_ASYNC_DEPTH].isLast = 1; // Completion callback fires after this entry
+    lcd->asyncHead = lcd->asyncStage;
+    LCD1602_I2C_AsyncKick(lcd);
+    return LCD1602_I2C_OK;
+}
+
+
+void LCD1602_I2C_AsyncKick(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+
+    if(lcd->sched){ // The bus is shared, the scheduler decides which display goes next
+        LCD1602_I2C_SchedDispatch(lcd->sched);
+        return;
+    }
+
+    LCD1602_I2C_ENTER_CRITICAL(); // Called from both the application and the completion interrupt
+    if(lcd->asyncState != LCD1602_I2C_ASYNC_IDLE || lcd->asyncHead == lcd->asyncTail){
+        LCD1602_I2C_EXIT_CRITICAL();
+        return;
+    }
+    lcd->asyncState = LCD1602_I2C_ASYNC_TRANSMITTING;
+    LCD1602_I2C_EXIT_CRITICAL();
+
+    if(lcd->transport->writeAsync){
+        status = LCD1602_I2C_TRACE_BUS(lcd, LCD1602_I2C_TRACE_ASYNC, lcd->asyncQueue[lcd->asyncTail].frames, lcd->asyncQueue[lcd->asyncTail].length, lcd->transport->writeAsync(lcd->bus, lcd->address, lcd->asyncQueue[lcd->asyncTail].frames, lcd->asyncQueue[lcd->asyncTail].length));
+    } else { // Transport without interrupt support, send now and complete right away
+        status = LCD1602_I2C_BusWrite(lcd, lcd->asyncQueue[lcd->asyncTail].frames, lcd->asyncQueue[lcd->asyncTail].length);
+        if(status == LCD1602_I2C_OK) LCD1602_I2C_AsyncTxComplete(lcd);
+    }
+    if(status != LCD1602_I2C_OK){
+        LCD1602_I2C_AsyncTxError(lcd); // Drop the call that could not be started
+    }
+}
+
+
+void LCD1602_I2C_SchedDispatch(LCD1602_I2C_Sched_t* sched){
+    { // Called from both the application and the completion interrupt, only one dispatch runs at a time
+        LCD1602_I2C_ENTER_CRITICAL();
+        if(sched->dispatching){
+            sched->redispatch = 1;
+            LCD1602_I2C_EXIT_CRITICAL();
+            return;
+        }
+        sched->dispatching = 1;
+        LCD1602_I2C_EXIT_CRITICAL();
+    }
+
+    for(;;){
+        LCD1602_I2C_t* lcd = 0;
+        LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+
+        sched->redispatch = 0;
+        for(__UINT8_TYPE__ i = 0; i < sched->count && !sched->active; i++){ // Round-robin over the displays that can take a transfer now
+            LCD1602_I2C_t* candidate = sched->displays[(sched->next + i) % sched->count];
+            if(candidate->asyncState == LCD1602_I2C_ASYNC_IDLE && candidate->asyncHead != candidate->asyncTail){
+                lcd = candidate;
+                sched->next = (sched->next + i + 1) % sched->count;
+                break;
+            }
+        }
+
+        if(lcd){ // Otherwise the bus is in use or every display is empty or still executing, a completion or LCD1602_I2C_SchedPoll dispatches again
+            lcd->asyncState = LCD1602_I2C_ASYNC_TRANSMITTING;
+            sched->active = lcd;
+            if(lcd->transport->writeAsync){
+                status = LCD1602_I2C_TRACE_BUS(lcd, LCD1602_I2C_TRACE_ASYNC, lcd->asyncQueue[lcd->asyncTail].frames, lcd->asyncQueue[lcd->asyncTail].length, lcd->transport->writeAsync(lcd->bus, lcd->address, lcd->asyncQueue[lcd->asyncTail].frames, lcd->asyncQueue[lcd->asyncTail].length));
+            } else { // Transport without interrupt support, send now and complete right away
+                status = LCD1602_I2C_BusWrite(lcd, lcd->asyncQueue[lcd->asyncTail].frames, lcd->asyncQueue[lcd->asyncTail].length);
+                if(status == LCD1602_I2C_OK) LCD1602_I2C_SchedTxComplete(sched);
+            }
+            if(status != LCD1602_I2C_OK){
+                LCD1602_I2C_SchedTxError(sched); // Drop the call that could not be started
+            }
+        }
+
+        { // Stop unless a completion came in meanwhile
+            LCD1602_I2C_ENTER_CRITICAL();
+            if(!sched->redispatch){
+                sched->dispatching = 0;
+                LCD1602_I2C_EXIT_CRITICAL();
+                return;
+            }
+            LCD1602_I2C_EXIT_CRITICAL();
+        }
+    }
+}
+
+
+
+
+#if LCD1602_I2C_TRACE
+LCD1602_I2C_TraceScope_t LCD1602_I2C_TraceEnter(LCD1602_I2C_t* lcd, LCD1602_I2C_Api_t api){
+    LCD1602_I2C_TraceScope_t scope = {lcd, 0, LCD1602_I2C_API_COUNT};
+
+    if(lcd->traceDepth++ == 0){
+        scope.start = LCD1602_I2C_Micros(lcd);
+        scope.api = (__UINT8_TYPE__)api;
+    }
+    return scope;
+}
+
+
+void LCD1602_I2C_TraceLeave(LCD1602_I2C_TraceScope_t* scope){
+    LCD1602_I2C_t* lcd = scope->lcd;
+    __UINT32_TYPE__ elapsed = 0;
+
+    if(lcd->traceDepth > 0) lcd->traceDepth--;
+    if(scope->api == LCD1602_I2C_API_COUNT) return;
+    elapsed = LCD1602_I2C_Micros(lcd) - scope->start;
+    lcd->trace.apiCalls[scope->api]++;
+    lcd->trace.apiUs[scope->api] += elapsed;
+    if(elapsed > lcd->trace.apiMaxUs[scope->api]) lcd->trace.apiMaxUs[scope->api] = elapsed;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_TraceBus(LCD1602_I2C_t* lcd, __UINT8_TYPE__ flags, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ start, LCD1602_I2C_Status_t status){
+    __UINT8_TYPE__ kind = flags & LCD1602_I2C_TRACE_KIND;
+
+    lcd->trace.transactions++;
+    lcd->trace.bytes += length;
+    if(kind == LCD1602_I2C_TRACE_PROBE) lcd->trace.probes++;
+    if(kind != LCD1602_I2C_TRACE_ASYNC) lcd->trace.busUs += LCD1602_I2C_Micros(lcd) - start; // A queued transfer only starts here
+    if(status != LCD1602_I2C_OK){
+        flags |= LCD1602_I2C_TRACE_FAILED;
+        if(lcd->asyncState != LCD1602_I2C_ASYNC_TRANSMITTING) lcd->trace.errors++; // Failed queued transfers are counted by LCD1602_I2C_AsyncTxError
+    }
+    LCD1602_I2C_TraceLog(lcd, flags, data, length, start);
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_TraceSegments(LCD1602_I2C_t* lcd, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count, __UINT32_TYPE__ start, LCD1602_I2C_Status_t status){
+    __UINT8_TYPE__ failed = (status != LCD1602_I2C_OK) ? LCD1602_I2C_TRACE_FAILED : 0x00;
+
+    lcd->trace.transactions++;
+    lcd->trace.busUs += LCD1602_I2C_Micros(lcd) - start;
+    if(failed) lcd->trace.errors++;
+    for(__UINT8_TYPE__ i = 0; i < count; i++){
+        lcd->trace.bytes += segments[i].length;
+        LCD1602_I2C_TraceLog(lcd, (segments[i].read ? LCD1602_I2C_TRACE_READ : LCD1602_I2C_TRACE_WRITE) | failed, segments[i].data, segments[i].length, start);
+    }
+    return status;
+}
+
+
+void LCD1602_I2C_TraceLog(LCD1602_I2C_t* lcd, __UINT8_TYPE__ flags, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ start){
+    __UINT32_TYPE__ head = lcd->traceHead;
+
+    for(__UINT16_TYPE__ i = 0; i < length || i == 0; i++){
+        LCD1602_I2C_TraceEntry_t* entry = &lcd->traceRing[head & (LCD1602_I2C_TRACE_DEPTH - 1)];
+        entry->timestamp = start;
+        entry->frame = length ? data[i] : 0x00;
+        entry->flags = flags | ((i == 0) ? LCD1602_I2C_TRACE_START : 0x00);
+        LCD1602_I2C_MEMORY_BARRIER(); // A reader that sees the new head sees the whole entry
+        lcd->traceHead = ++head;
+    }
+}
+#endif
+
+
+// Global functions definition
+
+LCD1602_I2C_Status_t LCD1602_I2C_Init(LCD1602_I2C_t* lcd, const LCD1602_I2C_Transport_t* transport, void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ busKhz){
+    return LCD1602_I2C_InitExpander(lcd, transport, bus, address, busKhz, LCD1602_I2C_PCF8574);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_InitExpander(LCD1602_I2C_t* lcd, const LCD1602_I2C_Transport_t* transport, void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ busKhz, LCD1602_I2C_Expander_t expander){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ frames[4];
+    __UINT8_TYPE__ length = 0;
+    memset(lcd, 0, sizeof(*lcd)); // Contexts may live on the stack or be re-initialized, start from a known state
+    lcd->transport = transport;
+    lcd->bus = bus;
+    lcd->address = address;
+    lcd->expander = (__UINT8_TYPE__)expander;
+    lcd->backlight = 1;
+    lcd->readyAt = LCD1602_I2C_POWER_ON_US;
+    lcd->busKhz = busKhz ? busKhz : LCD1602_I2C_BUS_KHZ;
+    lcd->latchLeadUs = ((expander == LCD1602_I2C_PCF8575) ? 45000 : 27000) / lcd->busKhz; // Same formula as LCD1602_I2C_LATCH_LEAD_US, a PCF8575 latches after 2 port writes
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_INIT);
+    LCD1602_I2C_SetGeometry(lcd, LCD1602_I2C_16X2);
+    memset(lcd->shadowGlyph, 0xFF, sizeof(lcd->shadowGlyph)); // LCD1602_I2C_GLYPH_NONE, CGRAM content is unknown after power-on
+    LCD1602_I2C_GlyphForget(lcd);
+    for(__UINT8_TYPE__ i = 0; i < 8; i++){
+        lcd->glyphLru[i] = i;
+    }
+    lcd->utf8Glyphs = g_utf8Glyphs;
+    lcd->utf8GlyphCount = sizeof(g_utf8Glyphs) / sizeof(g_utf8Glyphs[0]);
+
+    // Wait for the LCD to power up, only the part of the 40ms that has not elapsed since power-on is waited for (readyAt starts at LCD1602_I2C_POWER_ON_US)
+
+    // Function set (8-bit) pulses, the HD44780U needs a pause after the first two so they go out one by one
+    length = LCD1602_I2C_EncodeReset(lcd, 0x3, frames);
+    for(__UINT8_TYPE__ i = 0; i < length && status == LCD1602_I2C_OK; i++) status = LCD1602_I2C_BurstAppendRaw(lcd, frames[i]);
+    lcd->lastExecUs = 4100; // More than 4.1ms
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_BurstCommit(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+
+    for(__UINT8_TYPE__ i = 0; i < length && status == LCD1602_I2C_OK; i++) status = LCD1602_I2C_BurstAppendRaw(lcd, frames[i]);
+    lcd->lastExecUs = 100; // More than 100us
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_BurstCommit(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+
+    // Everything up to the clear goes out as one transaction
+    LCD1602_I2C_BurstBegin(lcd);
+
+    for(__UINT8_TYPE__ i = 0; i < length && status == LCD1602_I2C_OK; i++) status = LCD1602_I2C_BurstAppendRaw(lcd, frames[i]);
+    lcd->lastExecUs = g_execTimeUs[5]; // Function set
+
+    // Set 4-bit operation mode, a PCF8575 keeps the 8-bit interface
+    if(status == LCD1602_I2C_OK && lcd->expander == LCD1602_I2C_PCF8574) status = LCD1602_I2C_Set4BitMode(lcd);
+
+    // Function set: lines of the geometry, 5x8 dots
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_FunctionSet(lcd, lcd->twoLines, 0);
+
+    // Display ON, Cursor ON, Blink OFF
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_DisplayControl(lcd, 1, 1, 0);
+
+    // Clear display commits the burst and waits for the instruction to finish
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Clear_Display(lcd);
+
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_EntryModeSet(lcd, 1, 0); // Increment cursor, without display shift (shifting on every write would scroll the text away)
+
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    status = endStatus;
+    if(status != LCD1602_I2C_OK) return status;
+
+    memset(lcd->shadow, ' ', sizeof(lcd->shadow)); // Shadow matches the cleared display
+    lcd->warmMagic = LCD1602_I2C_WARM_MAGIC ^ (__UINT32_TYPE__)sizeof(*lcd);
+
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_WarmStart(LCD1602_I2C_t* lcd, const LCD1602_I2C_Transport_t* transport, void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ busKhz, LCD1602_I2C_Expander_t expander){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ cursor = lcd->ac;
+    __UINT8_TYPE__ trusted = 0;
+    __UINT8_TYPE__ test = 0;
+
+    if(lcd->warmMagic != (LCD1602_I2C_WARM_MAGIC ^ (__UINT32_TYPE__)sizeof(*lcd)) || lcd->address != address || lcd->expander != (__UINT8_TYPE__)expander){
+        return LCD1602_I2C_InitExpander(lcd, transport, bus, address, busKhz, expander); // Power-on, or the context of another build or display
+    }
+
+    // DDRAM holds the image unless the reset came while frames were encoded, queued or on the bus
+    trusted = lcd->ddramValid && !lcd->writing && !lcd->burstLength && !lcd->recoverStep && cursor != LCD1602_I2C_AC_UNKNOWN
+              && lcd->asyncHead == lcd->asyncTail && lcd->asyncState == LCD1602_I2C_ASYNC_IDLE;
+
+    // Everything else is reset as by LCD1602_I2C_Init, the pointers may be stale after a firmware update
+    lcd->transport = transport;
+    lcd->bus = bus;
+    lcd->busKhz = busKhz ? busKhz : LCD1602_I2C_BUS_KHZ;
+    lcd->latchLeadUs = ((expander == LCD1602_I2C_PCF8575) ? 45000 : 27000) / lcd->busKhz;
+#if LCD1602_I2C_TRACE
+    lcd->traceDepth = 0; // The counters and the trace ring are kept, a call the reset cut short never returns
+#endif
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_WARM_START);
+    lcd->burstLength = 0;
+    lcd->burstHold = 0;
+    lcd->glyphs = 0; // CGRAM keeps its glyphs, LCD1602_I2C_SetGlyphs registers the table again
+    lcd->glyphCount = 0;
+    lcd->utf8Glyphs = 0; // LCD1602_I2C_SetUtf8Glyphs registers it again, the built-in table included
+    lcd->utf8GlyphCount = 0;
+    memset(&lcd->utf8, 0, sizeof(lcd->utf8));
+    lcd->marqueeText[0] = 0;
+    lcd->marqueeText[1] = 0;
+    lcd->asyncHead = 0;
+    lcd->asyncTail = 0;
+    lcd->asyncStage = 0;
+    lcd->asyncCapture = 0;
+    lcd->asyncState = LCD1602_I2C_ASYNC_IDLE;
+    lcd->asyncCallback = 0;
+    lcd->busyPolling = 0;
+    lcd->busyPending = 0;
+    lcd->lastExecUs = 0;
+    lcd->budgetUs = 0;
+    lcd->deadlineOwner = 0;
+    lcd->recoverStep = 0;
+    lcd->regionCount = 0;
+    lcd->refreshPending = 0;
+    lcd->framePeriodUs = 0;
+    lcd->sched = 0;
+    lcd->writing = 0;
+    lcd->dataRegisterValid = 0; // The next read sends its address
+    lcd->readyAt = LCD1602_I2C_Micros(lcd); // No power-on wait, the LCD1602 kept its supply
+
+    status = LCD1602_I2C_BusProbe(lcd);
+    if(status != LCD1602_I2C_OK){
+        LCD1602_I2C_BusFailed(lcd); // The next call recovers
+        return status;
+    }
+
+    // The address counter is where the context left it, and follows a set DDRAM address: right interface mode, in nibble sync, nothing reached the LCD1602 since the last transfer
+    if(trusted) status = LCD1602_I2C_WarmCheck(lcd, (cursor & LCD1602_I2C_AC_CGRAM) ? (cursor & 0x3F) : cursor);
+    if(trusted && status == LCD1602_I2C_OK){
+        test = (cursor == 0x14) ? 0x41 : 0x14; // Nibbles that read back differently in 8-bit mode or out of sync, valid addresses in both line modes
+        lcd->ac = LCD1602_I2C_AC_UNKNOWN;
+        status = LCD1602_I2C_SetDDRAMAddress(lcd, test);
+        if(status == LCD1602_I2C_OK) status = LCD1602_I2C_WarmCheck(lcd, test);
+    }
+    if(!trusted || status == LCD1602_I2C_ERROR || status == LCD1602_I2C_TIMEOUT){
+        LCD1602_I2C_BusFailed(lcd); // Also for a controller that lost its supply, the reset sequence brings it back
+        status = LCD1602_I2C_Recover(lcd); // Without clear, DDRAM is redrawn from the shadow
+        if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Flush(lcd);
+        return status;
+    }
+    if(status != LCD1602_I2C_OK) return status; // Failed read or write, the next call recovers
+
+    // Restore what Init set up and the context remembers
+    LCD1602_I2C_BurstBegin(lcd);
+    status = LCD1602_I2C_FunctionSet(lcd, lcd->twoLines, 0);
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_DisplayControl(lcd, 1, 1, 0);
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_EntryModeSet(lcd, lcd->increment, lcd->entryShift);
+    if(status == LCD1602_I2C_OK){
+        status = (cursor & LCD1602_I2C_AC_CGRAM) ? LCD1602_I2C_SetCGRAMAddress(lcd, cursor & 0x3F) : LCD1602_I2C_SetDDRAMAddress(lcd, cursor);
+    }
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    if(status == LCD1602_I2C_OK) status = endStatus;
+    if(status != LCD1602_I2C_OK) return status;
+
+    return LCD1602_I2C_Flush(lcd); // Only the cells the shadow changed since
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Clear(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_CLEAR);
+    return LCD1602_I2C_Clear_Display(lcd);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ClearAsync(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_Clear(lcd));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_SetGeometry(LCD1602_I2C_t* lcd, LCD1602_I2C_Geometry_t geometry){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ initialized = (lcd->warmMagic == (LCD1602_I2C_WARM_MAGIC ^ (__UINT32_TYPE__)sizeof(*lcd))); // LCD1602_I2C_Init sends the Function set itself
+
+    if((unsigned)geometry >= sizeof(g_geometry) / sizeof(g_geometry[0])){
+        return LCD1602_I2C_ERROR; // Unknown geometry
+    }
+    if(initialized && lcd->twoLines != g_geometry[geometry][6] && (lcd->asyncCapture || lcd->asyncState != LCD1602_I2C_ASYNC_IDLE || lcd->asyncHead != lcd->asyncTail)){
+        return LCD1602_I2C_BUSY; // The Function set can not be queued behind the asynchronous transfers
+    }
+
+    lcd->columns = g_geometry[geometry][0];
+    lcd->rows = g_geometry[geometry][1];
+    memcpy(lcd->rowStart, &g_geometry[geometry][2], sizeof(lcd->rowStart));
+    if(lcd->rows > 2){
+        lcd->marqueeText[0] = 0;
+        lcd->marqueeText[1] = 0;
+    }
+    if(lcd->twoLines == g_geometry[geometry][6]) return LCD1602_I2C_OK;
+
+    // The DDRAM layout changes with the number of lines, start again from a cleared display, the next LCD1602_I2C_Flush redraws the shadow framebuffer
+    lcd->twoLines = g_geometry[geometry][6];
+    if(!initialized) return LCD1602_I2C_OK;
+    LCD1602_I2C_BurstBegin(lcd);
+    status = LCD1602_I2C_FunctionSet(lcd, lcd->twoLines, 0);
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Clear_Display(lcd); // Also stops the marquees
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    if(status == LCD1602_I2C_OK) status = endStatus;
+    if(status != LCD1602_I2C_OK) LCD1602_I2C_BusFailed(lcd); // The next call resynchronizes, with the Function set of the new geometry
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_MoveCursor(LCD1602_I2C_t* lcd, int x, int y){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_MOVE_CURSOR);
+    __UINT8_TYPE__ line = 0;
+    __UINT8_TYPE__ end = 0;
+    __UINT8_TYPE__ column = LCD1602_I2C_RowCell(lcd, x, y, &line, &end);
+
+    if(column == 0xFF){
+        return LCD1602_I2C_ERROR; // Invalid position
+    }
+
+    return LCD1602_I2C_SetDDRAMAddress(lcd, LCD1602_I2C_CellAddress(lcd, column, line));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_MoveCursorAsync(LCD1602_I2C_t* lcd, int x, int y){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_MoveCursor(lcd, x, y));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowChar(LCD1602_I2C_t* lcd, char c){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SHOW_CHAR);
+    return LCD1602_I2C_Write_Data(lcd, c);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowCharAsync(LCD1602_I2C_t* lcd, char c){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_ShowChar(lcd, c));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowString(LCD1602_I2C_t* lcd, char* str){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SHOW_STRING);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    LCD1602_I2C_BurstBegin(lcd); // The whole string goes out in as few transactions as the burst buffer allows
+    while(*str){
+        status = LCD1602_I2C_Write_Data(lcd, (__UINT8_TYPE__)(*str));
+        if(status != LCD1602_I2C_OK) break;
+        str++;
+    }
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    return (status != LCD1602_I2C_OK) ? status : endStatus;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowStringAsync(LCD1602_I2C_t* lcd, char* str){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_ShowString(lcd, str));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowWrapped(LCD1602_I2C_t* lcd, int x, int y, const char* str){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SHOW_WRAPPED);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    const char* text[4] = {0, 0, 0, 0};
+    __UINT8_TYPE__ start[4] = {0, 0, 0, 0};
+    __UINT8_TYPE__ length[4] = {0, 0, 0, 0};
+    __UINT8_TYPE__ increment = lcd->increment;
+    __UINT8_TYPE__ entryShift = lcd->entryShift;
+    __UINT8_TYPE__ endRow = (__UINT8_TYPE__)y;
+    __UINT8_TYPE__ endColumn = (__UINT8_TYPE__)x;
+
+    if(x < 0 || x >= lcd->columns || y < 0 || y >= lcd->rows){
+        return LCD1602_I2C_ERROR; // Invalid position
+    }
+
+    // Cut the text into rows in reading order, the cursor ends after the last character
+    for(__UINT8_TYPE__ row = (__UINT8_TYPE__)y; row < lcd->rows && *str; row++){
+        start[row] = (row == y) ? (__UINT8_TYPE__)x : 0;
+        text[row] = str;
+        while(*str && start[row] + length[row] < lcd->columns){
+            length[row]++;
+            str++;
+        }
+        endRow = (start[row] + length[row] < lcd->columns) ? row : row + 1; // Past the last row the cursor stays after the last write
+        endColumn = (endRow == row) ? start[row] + length[row] : 0;
+    }
+
+    LCD1602_I2C_BurstBegin(lcd);
+    if(!increment || entryShift) status = LCD1602_I2C_EntryModeSet(lcd, 1, 0); // Written left to right with a still display
+
+    // Send in DDRAM order: row r is on line r % 2 in every geometry and the rows of a line follow each other, so 0x27 runs into 0x40
+    for(__UINT8_TYPE__ line = 0; line < 2; line++){
+        for(__UINT8_TYPE__ row = line; row < lcd->rows; row += 2){
+            for(__UINT8_TYPE__ k = 0; k < length[row] && status == LCD1602_I2C_OK; k++){
+                status = LCD1602_I2C_SetDDRAMAddress(lcd, LCD1602_I2C_CellAddress(lcd, (lcd->rowStart[row] & 0x3F) + start[row] + k, line)); // Free inside a run
+                if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Write_Data(lcd, (__UINT8_TYPE__)text[row][k]);
+            }
+        }
+    }
+
+    if(status == LCD1602_I2C_OK && (!increment || entryShift)) status = LCD1602_I2C_EntryModeSet(lcd, increment, entryShift);
+    if(status == LCD1602_I2C_OK && endRow < lcd->rows){
+        status = LCD1602_I2C_SetDDRAMAddress(lcd, LCD1602_I2C_CellAddress(lcd, (lcd->rowStart[endRow] & 0x3F) + endColumn, lcd->rowStart[endRow] >> 6));
+    }
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    return (status != LCD1602_I2C_OK) ? status : endStatus;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShiftDisplay(LCD1602_I2C_t* lcd, int right){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SHIFT_DISPLAY);
+    if(right != 0 && right != 1){
+        return LCD1602_I2C_ERROR; // Invalid parameter
+    }
+    return LCD1602_I2C_CursorDisplayShift(lcd, 1, right);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShiftDisplayAsync(LCD1602_I2C_t* lcd, int right){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_ShiftDisplay(lcd, right));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShadowWrite(LCD1602_I2C_t* lcd, int x, int y, char* str){
+    __UINT8_TYPE__ line = 0;
+    __UINT8_TYPE__ end = 0;
+    __UINT8_TYPE__ column = LCD1602_I2C_RowCell(lcd, x, y, &line, &end);
+
+    if(column == 0xFF){
+        return LCD1602_I2C_ERROR; // Invalid position
+    }
+
+    while(*str && column < end){ // Characters beyond the last column are dropped
+        lcd->shadowGlyph[line][column] = LCD1602_I2C_GLYPH_NONE;
+        lcd->shadow[line][column++] = (__UINT8_TYPE__)(*str);
+        str++;
+    }
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Printf(LCD1602_I2C_t* lcd, const char* fmt, ...){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_PRINTF);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    va_list args;
+
+    va_start(args, fmt);
+    LCD1602_I2C_BurstBegin(lcd); // Characters are encoded into the burst buffer as they are formatted
+    status = LCD1602_I2C_Format(LCD1602_I2C_PutDisplay, lcd, fmt, args);
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    va_end(args);
+    return (status != LCD1602_I2C_OK) ? status : endStatus;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_PrintfAsync(LCD1602_I2C_t* lcd, const char* fmt, ...){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    va_list args;
+
+    if(status != LCD1602_I2C_OK) return status;
+    va_start(args, fmt);
+    LCD1602_I2C_BurstBegin(lcd);
+    status = LCD1602_I2C_Format(LCD1602_I2C_PutDisplay, lcd, fmt, args);
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    va_end(args);
+    return LCD1602_I2C_AsyncEnd(lcd, (status != LCD1602_I2C_OK) ? status : endStatus);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShadowPrintf(LCD1602_I2C_t* lcd, int x, int y, const char* fmt, ...){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    LCD1602_I2C_ShadowCursor_t cursor = {lcd, 0, 0, 0};
+    va_list args;
+
+    cursor.x = LCD1602_I2C_RowCell(lcd, x, y, &cursor.y, &cursor.end);
+    if(cursor.x == 0xFF){
+        return LCD1602_I2C_ERROR; // Invalid position
+    }
+
+    va_start(args, fmt);
+    status = LCD1602_I2C_Format(LCD1602_I2C_PutShadow, &cursor, fmt, args);
+    va_end(args);
+    return status;
+}
+
+
+void LCD1602_I2C_ShadowClear(LCD1602_I2C_t* lcd){
+    memset(lcd->shadow, ' ', sizeof(lcd->shadow));
+    memset(lcd->shadowGlyph, 0xFF, sizeof(lcd->shadowGlyph)); // LCD1602_I2C_GLYPH_NONE
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShadowGlyph(LCD1602_I2C_t* lcd, int x, int y, __UINT16_TYPE__ id){
+    __UINT8_TYPE__ line = 0;
+    __UINT8_TYPE__ end = 0;
+    __UINT8_TYPE__ column = LCD1602_I2C_RowCell(lcd, x, y, &line, &end);
+
+    if(column == 0xFF || !LCD1602_I2C_GlyphBitmap(lcd, id)){
+        return LCD1602_I2C_ERROR; // Invalid position or glyph
+    }
+
+    lcd->shadowGlyph[line][column] = id; // The CGRAM character is chosen by the flush
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Flush(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_FLUSH);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ fullRedraw = !lcd->ddramValid && (lcd->marqueeText[0] || lcd->marqueeText[1]); // LCD1602_I2C_MarqueeStep trusts ddram too, the marquee rows have to stay unknown
+    __UINT8_TYPE__ written = 0;
+    __UINT8_TYPE__ cursor = lcd->ac;
+    __UINT8_TYPE__ increment = lcd->increment;
+    __UINT8_TYPE__ entryShift = lcd->entryShift;
+    __UINT16_TYPE__ pendingFrom = 0xFFFF; // First cell (y * 40 + x) written since the last commit
+    __UINT16_TYPE__ pendingTo = 0; // One past the last cell written
+
+    if(!lcd->ddramValid && !fullRedraw){ // Make every cell differ from the shadow instead, a redraw cut short by the budget then resumes where it stopped
+        for(__UINT8_TYPE__ y = 0; y < 1 + lcd->twoLines; y++){
+            for(__UINT8_TYPE__ x = 0; x < 40; x++){
+                *LCD1602_I2C_DdramCell(lcd, LCD1602_I2C_CellAddress(lcd, x, y)) = (__UINT8_TYPE__)~lcd->shadow[y][x];
+            }
+        }
+        lcd->ddramValid = 1;
+    }
+
+    LCD1602_I2C_BurstBegin(lcd); // All runs go out in as few transactions as the burst buffer allows
+    status = LCD1602_I2C_ShadowLoadGlyphs(lcd); // Uploads go first, a cell is only drawn once its glyph is in CGRAM
+    for(__UINT8_TYPE__ y = 0; y < 1 + lcd->twoLines && status == LCD1602_I2C_OK; y++){ // Line 1 of the shadow has no DDRAM in 1 line mode
+        __UINT8_TYPE__ nextAddr = 0xFF; // Address counter after the last write of the current run, 0xFF when no run is open
+        __UINT8_TYPE__ skipped = 0; // Clean cells passed since the last write of the current run
+
+        if(lcd->marqueeText[y]) continue; // Owned by LCD1602_I2C_MarqueeStep
+        for(__UINT8_TYPE__ x = 0; x < 40 && status == LCD1602_I2C_OK; x++){
+            __UINT8_TYPE__ addr = LCD1602_I2C_CellAddress(lcd, x, y);
+            __UINT8_TYPE__ c = lcd->shadow[y][x];
+            __UINT16_TYPE__ length = lcd->burstLength;
+
+            if(!fullRedraw && *LCD1602_I2C_DdramCell(lcd, addr) == c){ // Cell already shows the right character
+                skipped++;
+                continue;
+            }
+
+            if(!written && (!increment || entryShift)){ // Runs are written left to right with a still display
+                status = LCD1602_I2C_EntryModeSet(lcd, 1, 0);
+            }
+            if(status != LCD1602_I2C_OK) break;
+
+            if(nextAddr != 0xFF && skipped == 1 && addr == nextAddr + 1){
+                // Rewriting one clean cell costs the same as a new address, keep the run going
+                status = LCD1602_I2C_Write_Data(lcd, lcd->shadow[y][x - 1]);
+            } else { // Start a new run, free when the address counter already points to the cell
+                status = LCD1602_I2C_SetDDRAMAddress(lcd, addr);
+            }
+            if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Write_Data(lcd, c);
+            *LCD1602_I2C_DdramCell(lcd, addr) = c;
+            if(pendingFrom == 0xFFFF || (status == LCD1602_I2C_OK && lcd->burstLength < length)) pendingFrom = y * 40 + x; // The burst buffer was sent to make room for this cell
+            pendingTo = y * 40 + x + 1;
+            written = 1;
+            skipped = 0;
+            nextAddr = ((addr & 0x3F) == 0x27) ? 0xFF : addr + 1; // The address counter leaves the line after 0x27/0x67
+        }
+    }
+
+    if(status == LCD1602_I2C_OK && !(cursor & LCD1602_I2C_AC_CGRAM)){ // Put the cursor back where the application left it, free if nothing moved it (LCD1602_I2C_AC_UNKNOWN has the bit set too)
+        status = LCD1602_I2C_SetDDRAMAddress(lcd, cursor);
+    }
+    if(status == LCD1602_I2C_OK && written && (!increment || entryShift)){
+        status = LCD1602_I2C_EntryModeSet(lcd, increment, entryShift);
+    }
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    if(status == LCD1602_I2C_OK) status = endStatus;
+
+    if(status == LCD1602_I2C_DEADLINE && !fullRedraw && !lcd->recoverStep){ // Nothing was sent since the last commit, only the cells written after it are wrong
+        for(__UINT16_TYPE__ i = pendingFrom; i < pendingTo; i++){
+            __UINT8_TYPE__ y = i / 40;
+            __UINT8_TYPE__ x = i % 40;
+            if(!lcd->marqueeText[y]) *LCD1602_I2C_DdramCell(lcd, LCD1602_I2C_CellAddress(lcd, x, y)) = (__UINT8_TYPE__)~lcd->shadow[y][x];
+        }
+        lcd->ddramValid = 1;
+    } else {
+        lcd->ddramValid = (status == LCD1602_I2C_OK); // After a failure the content is unknown again
+    }
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_SetEntryMode(LCD1602_I2C_t* lcd, int increment, int shift){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SET_ENTRY_MODE);
+    return LCD1602_I2C_EntryModeSet(lcd, increment ? 1 : 0, shift ? 1 : 0);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_MarqueeStart(LCD1602_I2C_t* lcd, int y, const char* text){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_MARQUEE_START);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ cursor = lcd->ac;
+    __UINT8_TYPE__ increment = lcd->increment;
+    __UINT8_TYPE__ entryShift = lcd->entryShift;
+
+    if(y < 0 || y >= lcd->rows || lcd->rows > 2 || !text || !text[0]){ // On 4 rows displays the shift would scroll 2 rows as one
+        return LCD1602_I2C_ERROR; // Invalid row or text
+    }
+
+    lcd->marqueeText[y] = text;
+    lcd->marqueeLength[y] = (__UINT16_TYPE__)strlen(text);
+    lcd->marqueePos[y] = 0;
+
+    LCD1602_I2C_BurstBegin(lcd);
+    status = LCD1602_I2C_MarqueeRefill(lcd, (__UINT8_TYPE__)y, 0, 40);
+    if(status == LCD1602_I2C_OK && !(cursor & LCD1602_I2C_AC_CGRAM)) status = LCD1602_I2C_SetDDRAMAddress(lcd, cursor);
+    if(status == LCD1602_I2C_OK && (lcd->increment != increment || lcd->entryShift != entryShift)) status = LCD1602_I2C_EntryModeSet(lcd, increment, entryShift);
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    if(status == LCD1602_I2C_OK) status = endStatus;
+    if(status != LCD1602_I2C_OK) lcd->marqueeText[y] = 0;
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_MarqueeStep(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_MARQUEE_STEP);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ cursor = lcd->ac;
+    __UINT8_TYPE__ increment = lcd->increment;
+    __UINT8_TYPE__ entryShift = lcd->entryShift;
+
+    if(!lcd->marqueeText[0] && !lcd->marqueeText[1]){
+        return LCD1602_I2C_ERROR; // Nothing to scroll
+    }
+
+    LCD1602_I2C_BurstBegin(lcd);
+    status = LCD1602_I2C_CursorDisplayShift(lcd, 1, 0); // Shift left, the text moves towards the first column
+    for(__UINT8_TYPE__ y = 0; y < 2 && status == LCD1602_I2C_OK; y++){
+        if(!lcd->marqueeText[y]) continue;
+        lcd->marqueePos[y] = (__UINT16_TYPE__)((lcd->marqueePos[y] + 1) % ((lcd->marqueeLength[y] > 40) ? lcd->marqueeLength[y] : 40));
+        status = LCD1602_I2C_MarqueeRefill(lcd, y, 39, 1); // The column that just left the display on the left comes back on the right
+    }
+    if(status == LCD1602_I2C_OK && !(cursor & LCD1602_I2C_AC_CGRAM)) status = LCD1602_I2C_SetDDRAMAddress(lcd, cursor); // Free when nothing was refilled
+    if(status == LCD1602_I2C_OK && (lcd->increment != increment || lcd->entryShift != entryShift)) status = LCD1602_I2C_EntryModeSet(lcd, increment, entryShift);
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    return (status != LCD1602_I2C_OK) ? status : endStatus;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_MarqueeStepAsync(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_MarqueeStep(lcd));
+}
+
+
+void LCD1602_I2C_MarqueeStop(LCD1602_I2C_t* lcd, int y){
+    if(y < 0 || y >= 2) return;
+    lcd->marqueeText[y] = 0;
+}
+
+
+void LCD1602_I2C_SetGlyphs(LCD1602_I2C_t* lcd, const LCD1602_I2C_Glyph_t* glyphs, __UINT16_TYPE__ count){
+    lcd->glyphs = glyphs;
+    lcd->glyphCount = glyphs ? ((count > LCD1602_I2C_GLYPH_UTF8) ? LCD1602_I2C_GLYPH_UTF8 : count) : 0;
+    LCD1602_I2C_GlyphForget(lcd); // Ids may now name other bitmaps
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowGlyph(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SHOW_GLYPH);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ cursor = lcd->ac;
+    __UINT8_TYPE__ slot = 0;
+
+    if(!LCD1602_I2C_GlyphBitmap(lcd, id)){
+        return LCD1602_I2C_ERROR; // Unregistered glyph
+    }
+    if((cursor & LCD1602_I2C_AC_CGRAM) && LCD1602_I2C_GlyphFind(lcd, id) == 0xFF){
+        return LCD1602_I2C_ERROR; // The cursor could not be put back after the upload
+    }
+
+    LCD1602_I2C_BurstBegin(lcd); // Upload, cursor and character go out as one transaction
+    status = LCD1602_I2C_GlyphLoad(lcd, id, 0, &slot);
+    if(status == LCD1602_I2C_OK && !(cursor & LCD1602_I2C_AC_CGRAM)) status = LCD1602_I2C_SetDDRAMAddress(lcd, cursor); // Free on a hit
+    if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Write_Data(lcd, slot);
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    return (status != LCD1602_I2C_OK) ? status : endStatus;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowGlyphAsync(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_ShowGlyph(lcd, id));
+}
+
+
+void LCD1602_I2C_GlyphStats(LCD1602_I2C_t* lcd, __UINT32_TYPE__* hits, __UINT32_TYPE__* misses){
+    if(hits) *hits = lcd->glyphHits;
+    if(misses) *misses = lcd->glyphMisses;
+}
+
+
+void LCD1602_I2C_SetRom(LCD1602_I2C_t* lcd, LCD1602_I2C_Rom_t rom){
+    lcd->rom = (__UINT8_TYPE__)rom;
+}
+
+
+void LCD1602_I2C_SetUtf8Glyphs(LCD1602_I2C_t* lcd, const LCD1602_I2C_Utf8Glyph_t* glyphs, __UINT16_TYPE__ count){
+    if(!glyphs){
+        glyphs = g_utf8Glyphs;
+        count = sizeof(g_utf8Glyphs) / sizeof(g_utf8Glyphs[0]);
+    }
+    lcd->utf8Glyphs = glyphs;
+    lcd->utf8GlyphCount = (count > 0x7FFF) ? 0x7FFF : count;
+    for(__UINT8_TYPE__ i = 0; i < 8; i++){ // Ids may now name other bitmaps
+        if(lcd->glyphSlot[i] & LCD1602_I2C_GLYPH_UTF8) lcd->glyphSlot[i] = LCD1602_I2C_GLYPH_NONE; // LCD1602_I2C_GLYPH_NONE stays
+    }
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShowUtf8(LCD1602_I2C_t* lcd, const char* str){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SHOW_UTF8);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT32_TYPE__ codepoints[2];
+    __UINT16_TYPE__ cells[2];
+
+    LCD1602_I2C_BurstBegin(lcd); // Characters and glyph uploads go out in as few transactions as the burst buffer allows
+    while(*str && status == LCD1602_I2C_OK){
+        __UINT8_TYPE__ decoded = LCD1602_I2C_Utf8Decode(&lcd->utf8, (__UINT8_TYPE__)(*str++), codepoints);
+
+        for(__UINT8_TYPE__ i = 0; i < decoded && status == LCD1602_I2C_OK; i++){
+            __UINT8_TYPE__ length = LCD1602_I2C_Utf8Map(lcd, codepoints[i], cells);
+
+            for(__UINT8_TYPE__ k = 0; k < length && status == LCD1602_I2C_OK; k++){
+                if(cells[k] < 0x100){
+                    status = LCD1602_I2C_Write_Data(lcd, (__UINT8_TYPE__)cells[k]);
+                } else if((lcd->ac & LCD1602_I2C_AC_CGRAM) && LCD1602_I2C_GlyphFind(lcd, cells[k]) == 0xFF){
+                    status = LCD1602_I2C_Write_Data(lcd, (__UINT8_TYPE__)LCD1602_I2C_UTF8_REPLACEMENT); // No upload without knowing where to put the cursor back
+                } else {
+                    status = LCD1602_I2C_ShowGlyph(lcd, cells[k]);
+                }
+            }
+        }
+    }
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    return (status != LCD1602_I2C_OK) ? status : endStatus;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_ShadowUtf8(LCD1602_I2C_t* lcd, int x, int y, const char* str){
+    LCD1602_I2C_Utf8Decoder_t decoder = {0, 0, 0};
+    __UINT32_TYPE__ codepoints[2];
+    __UINT16_TYPE__ cells[2];
+    __UINT8_TYPE__ line = 0;
+    __UINT8_TYPE__ end = 0;
+    __UINT8_TYPE__ column = LCD1602_I2C_RowCell(lcd, x, y, &line, &end);
+
+    if(column == 0xFF){
+        return LCD1602_I2C_ERROR; // Invalid position
+    }
+
+    while(*str && column < end){ // Characters beyond the last column are dropped
+        __UINT8_TYPE__ decoded = LCD1602_I2C_Utf8Decode(&decoder, (__UINT8_TYPE__)(*str++), codepoints);
+        if(*str == 0 && decoder.pending) codepoints[decoded++] = 0xFFFD; // The text ends in the middle of a sequence
+
+        for(__UINT8_TYPE__ i = 0; i < decoded; i++){
+            __UINT8_TYPE__ length = LCD1602_I2C_Utf8Map(lcd, codepoints[i], cells);
+
+            for(__UINT8_TYPE__ k = 0; k < length && column < end; k++, column++){
+                lcd->shadowGlyph[line][column] = (cells[k] < 0x100) ? LCD1602_I2C_GLYPH_NONE : cells[k]; // The CGRAM character of a glyph is chosen by the flush
+                lcd->shadow[line][column] = (__UINT8_TYPE__)cells[k];
+            }
+        }
+    }
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_SetBacklight(LCD1602_I2C_t* lcd, int on){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SET_BACKLIGHT);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    lcd->backlight = on ? 1 : 0;
+    if(lcd->expander == LCD1602_I2C_PCF8575){ // Both ports, Enable stays low
+        status = LCD1602_I2C_BurstAppendRaw(lcd, 0x00);
+        if(status == LCD1602_I2C_OK) status = LCD1602_I2C_BurstAppendRaw(lcd, PCF8575_PINS_UNUSED | (on ? PCF8575_PIN_BL : 0x00));
+    } else {
+        status = LCD1602_I2C_BurstAppendRaw(lcd, on ? PIN_BL : 0x00); // Enable stays low, the LCD1602 ignores the frame
+    }
+    if(status != LCD1602_I2C_OK) return status;
+    return lcd->burstHold ? LCD1602_I2C_OK : LCD1602_I2C_BurstCommit(lcd);
+}
+
+
+void LCD1602_I2C_SetBudget(LCD1602_I2C_t* lcd, __UINT32_TYPE__ budgetUs){
+    lcd->budgetUs = budgetUs;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Recover(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_RECOVER);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ armed = 0;
+
+    if(lcd->asyncCapture || lcd->asyncState != LCD1602_I2C_ASYNC_IDLE || lcd->asyncHead != lcd->asyncTail){
+        return LCD1602_I2C_BUSY; // The bus is owned by the asynchronous drain
+    }
+    if(!lcd->recoverStep) LCD1602_I2C_BusFailed(lcd); // Forced by the application
+    armed = LCD1602_I2C_DeadlineArm(lcd, 2);
+    status = LCD1602_I2C_Resync(lcd);
+    if(armed) lcd->deadlineOwner = 0;
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Scrub(LCD1602_I2C_t* lcd, __UINT8_TYPE__ cells){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_SCRUB);
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ cursor = lcd->ac;
+    __UINT8_TYPE__ increment = lcd->increment;
+    __UINT8_TYPE__ entryShift = lcd->entryShift;
+
+    if(lcd->asyncCapture || lcd->asyncState != LCD1602_I2C_ASYNC_IDLE || lcd->asyncHead != lcd->asyncTail){
+        return LCD1602_I2C_BUSY; // Reads can not be queued, the bus is owned by the asynchronous drain
+    }
+    if(!lcd->ddramValid) return LCD1602_I2C_OK; // Nothing to compare with
+
+    LCD1602_I2C_BurstBegin(lcd);
+    if(!increment || entryShift) status = LCD1602_I2C_EntryModeSet(lcd, 1, 0); // Cells are read left to right, a rewrite must not shift the display
+    for(__UINT8_TYPE__ i = 0; i < cells && status == LCD1602_I2C_OK; i++){
+        __UINT8_TYPE__ address = lcd->twoLines ? (((lcd->scrubPos >= 40) ? 0x40 : 0x00) | (lcd->scrubPos % 40)) : lcd->scrubPos; // The 80 DDRAM cells in address order
+        __UINT8_TYPE__ data = 0x00;
+
+        status = LCD1602_I2C_SetDDRAMAddress(lcd, address); // Free when the read moved the address counter on to this cell, LCD1602_I2C_Read_Data sends it anyway after a repair
+        if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Read_Data(lcd, &data);
+        if(status != LCD1602_I2C_OK) break;
+        lcd->scrubChecked++;
+        if(data != *LCD1602_I2C_DdramCell(lcd, address)){
+            lcd->scrubCorrupted++;
+            status = LCD1602_I2C_SetDDRAMAddress(lcd, address);
+            if(status == LCD1602_I2C_OK) status = LCD1602_I2C_Write_Data(lcd, *LCD1602_I2C_DdramCell(lcd, address)); // Back on the next cell
+        }
+        if(status == LCD1602_I2C_OK) lcd->scrubPos = (lcd->scrubPos + 1) % 80;
+    }
+
+    if(status == LCD1602_I2C_OK && cursor != LCD1602_I2C_AC_UNKNOWN){ // Put the cursor back where the application left it
+        status = (cursor & LCD1602_I2C_AC_CGRAM) ? LCD1602_I2C_SetCGRAMAddress(lcd, cursor & 0x3F) : LCD1602_I2C_SetDDRAMAddress(lcd, cursor);
+    }
+    if(status == LCD1602_I2C_OK && (!increment || entryShift)){
+        status = LCD1602_I2C_EntryModeSet(lcd, increment, entryShift);
+    }
+    LCD1602_I2C_Status_t endStatus = LCD1602_I2C_BurstEnd(lcd);
+    if(status == LCD1602_I2C_OK) status = endStatus;
+    if(status == LCD1602_I2C_DEADLINE) lcd->ac = LCD1602_I2C_AC_UNKNOWN; // The cursor may not have been put back
+    return status;
+}
+
+
+void LCD1602_I2C_ScrubStats(LCD1602_I2C_t* lcd, __UINT32_TYPE__* checked, __UINT32_TYPE__* corrupted){
+    if(checked) *checked = lcd->scrubChecked;
+    if(corrupted) *corrupted = lcd->scrubCorrupted;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_RegionAttach(LCD1602_I2C_t* lcd, LCD1602_I2C_Region_t* region, int x, int y, int width){
+    __UINT8_TYPE__ line = 0;
+    __UINT8_TYPE__ end = 0;
+    __UINT8_TYPE__ column = LCD1602_I2C_RowCell(lcd, x, y, &line, &end);
+
+    if(column == 0xFF || width < 1 || width > LCD1602_I2C_REGION_CHARS || column + width > end){
+        return LCD1602_I2C_ERROR; // Invalid position
+    }
+    if(lcd->regionCount >= LCD1602_I2C_REGIONS){
+        return LCD1602_I2C_ERROR;
+    }
+
+    memset(region, 0, sizeof(*region));
+    region->x = column;
+    region->y = line;
+    region->width = (__UINT8_TYPE__)width;
+    lcd->regions[lcd->regionCount++] = region;
+    return LCD1602_I2C_OK;
+}
+
+
+void LCD1602_I2C_RegionPost(LCD1602_I2C_Region_t* region, const char* str){
+    __UINT8_TYPE__ length = 0;
+
+    LCD1602_I2C_RegionPostBegin(region);
+    while(*str && length < region->width){
+        region->text[length++] = (__UINT8_TYPE__)(*str++);
+    }
+    LCD1602_I2C_RegionPostEnd(region, length);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_RegionPrintf(LCD1602_I2C_Region_t* region, const char* fmt, ...){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    LCD1602_I2C_RegionCursor_t cursor = {region, 0};
+    va_list args;
+
+    va_start(args, fmt);
+    LCD1602_I2C_RegionPostBegin(region);
+    status = LCD1602_I2C_Format(LCD1602_I2C_PutRegion, &cursor, fmt, args);
+    LCD1602_I2C_RegionPostEnd(region, cursor.x);
+    va_end(args);
+    return status;
+}
+
+
+void LCD1602_I2C_SetFrameRate(LCD1602_I2C_t* lcd, __UINT16_TYPE__ fps){
+    lcd->framePeriodUs = fps ? 1000000UL / fps : 0;
+    lcd->lastFrame = LCD1602_I2C_Micros(lcd) - lcd->framePeriodUs; // The next refresh is due right away
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Refresh(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_TRACE_API(lcd, LCD1602_I2C_API_REFRESH);
+    return LCD1602_I2C_RefreshFrame(lcd, LCD1602_I2C_Flush);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_RefreshAsync(LCD1602_I2C_t* lcd){
+    if(lcd->recoverStep){
+        return LCD1602_I2C_ERROR; // The queue would reach an LCD1602 out of sync, LCD1602_I2C_Recover first
+    }
+    return LCD1602_I2C_RefreshFrame(lcd, LCD1602_I2C_FlushAsync);
+}
+
+
+void LCD1602_I2C_SetBusyPolling(LCD1602_I2C_t* lcd, int enable){
+    lcd->busyPolling = enable ? 1 : 0;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_FlushAsync(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_AsyncBegin(lcd);
+    if(status != LCD1602_I2C_OK) return status;
+    return LCD1602_I2C_AsyncEnd(lcd, LCD1602_I2C_Flush(lcd));
+}
+
+
+void LCD1602_I2C_SetAsyncCallback(LCD1602_I2C_t* lcd, LCD1602_I2C_AsyncCallback_t callback){
+    lcd->asyncCallback = callback;
+}
+
+
+__UINT8_TYPE__ LCD1602_I2C_AsyncQueueDepth(LCD1602_I2C_t* lcd){
+    return (lcd->asyncHead + LCD1602_I2C_ASYNC_DEPTH - lcd->asyncTail) % LCD1602_I2C_ASYNC_DEPTH;
+}
+
+
+void LCD1602_I2C_AsyncTxComplete(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_AsyncEntry_t* entry = &lcd->asyncQueue[lcd->asyncTail];
+
+    if(lcd->asyncState != LCD1602_I2C_ASYNC_TRANSMITTING) return;
+
+    if(entry->settleUs){ // The instruction needs time, the next transfer starts from LCD1602_I2C_AsyncPoll
+        lcd->asyncSettleStart = LCD1602_I2C_Micros(lcd);
+        lcd->asyncState = LCD1602_I2C_ASYNC_SETTLING;
+        return;
+    }
+
+    lcd->asyncTail = (lcd->asyncTail + 1) % LCD1602_I2C_ASYNC_DEPTH;
+    lcd->asyncState = LCD1602_I2C_ASYNC_IDLE;
+    if(entry->isLast && lcd->asyncCallback) lcd->asyncCallback(lcd, LCD1602_I2C_OK);
+    LCD1602_I2C_AsyncKick(lcd);
+}
+
+
+void LCD1602_I2C_AsyncTxError(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_TRACE_COUNT(lcd, errors, 1);
+    // Drop every entry up to the end of the failed call, the rest of its sequence would be meaningless
+    while(lcd->asyncTail != lcd->asyncHead){
+        __UINT8_TYPE__ isLast = lcd->asyncQueue[lcd->asyncTail].isLast;
+        lcd->asyncTail = (lcd->asyncTail + 1) % LCD1602_I2C_ASYNC_DEPTH;
+        if(isLast) break;
+    }
+    lcd->asyncState = LCD1602_I2C_ASYNC_IDLE;
+    LCD1602_I2C_BusFailed(lcd); // An upload of the dropped call may be partial, LCD1602_I2C_Recover resynchronizes the LCD1602
+    if(lcd->asyncCallback) lcd->asyncCallback(lcd, LCD1602_I2C_ERROR);
+    LCD1602_I2C_AsyncKick(lcd);
+}
+
+
+void LCD1602_I2C_AsyncPoll(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_AsyncEntry_t* entry = &lcd->asyncQueue[lcd->asyncTail];
+
+    if(lcd->asyncState != LCD1602_I2C_ASYNC_SETTLING) return;
+    if(LCD1602_I2C_Micros(lcd) - lcd->asyncSettleStart < entry->settleUs + lcd->transport->timeResolutionUs) return;
+
+    lcd->asyncTail = (lcd->asyncTail + 1) % LCD1602_I2C_ASYNC_DEPTH;
+    lcd->asyncState = LCD1602_I2C_ASYNC_IDLE;
+    if(entry->isLast && lcd->asyncCallback) lcd->asyncCallback(lcd, LCD1602_I2C_OK);
+    LCD1602_I2C_AsyncKick(lcd);
+}
+
+
+void LCD1602_I2C_SchedInit(LCD1602_I2C_Sched_t* sched){
+    memset(sched, 0, sizeof(*sched));
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_SchedAttach(LCD1602_I2C_Sched_t* sched, LCD1602_I2C_t* lcd){
+    if(sched->count >= LCD1602_I2C_SCHED_DISPLAYS || lcd->sched){
+        return LCD1602_I2C_ERROR;
+    }
+    if(sched->count && (lcd->bus != sched->displays[0]->bus || lcd->transport != sched->displays[0]->transport)){
+        return LCD1602_I2C_ERROR; // One scheduler per bus
+    }
+    lcd->sched = sched;
+    sched->displays[sched->count++] = lcd;
+    return LCD1602_I2C_OK;
+}
+
+
+void LCD1602_I2C_SchedTxComplete(LCD1602_I2C_Sched_t* sched){
+    LCD1602_I2C_t* lcd = sched->active;
+
+    if(!lcd) return;
+    sched->active = 0;
+    LCD1602_I2C_AsyncTxComplete(lcd); // Starts settling, or releases the display right away
+    LCD1602_I2C_SchedDispatch(sched);
+}
+
+
+void LCD1602_I2C_SchedTxError(LCD1602_I2C_Sched_t* sched){
+    LCD1602_I2C_t* lcd = sched->active;
+
+    if(!lcd) return;
+    sched->active = 0;
+    LCD1602_I2C_AsyncTxError(lcd);
+    LCD1602_I2C_SchedDispatch(sched);
+}
+
+
+__UINT32_TYPE__ LCD1602_I2C_SchedPoll(LCD1602_I2C_Sched_t* sched){
+    __UINT32_TYPE__ wait = 0;
+
+    for(__UINT8_TYPE__ i = 0; i < sched->count; i++){
+        LCD1602_I2C_AsyncPoll(sched->displays[i]);
+    }
+    LCD1602_I2C_SchedDispatch(sched);
+    if(sched->active) return 0;
+
+    for(__UINT8_TYPE__ i = 0; i < sched->count; i++){ // Earliest deadline among the displays still executing
+        LCD1602_I2C_t* lcd = sched->displays[i];
+        if(lcd->asyncState == LCD1602_I2C_ASYNC_SETTLING){
+            __UINT32_TYPE__ elapsed = LCD1602_I2C_Micros(lcd) - lcd->asyncSettleStart;
+            __UINT32_TYPE__ needed = lcd->asyncQueue[lcd->asyncTail].settleUs + lcd->transport->timeResolutionUs;
+            __UINT32_TYPE__ remaining = (elapsed < needed) ? needed - elapsed : 1;
+            if(wait == 0 || remaining < wait) wait = remaining;
+        }
+    }
+    return wait;
+}
+
+
+__UINT16_TYPE__ LCD1602_I2C_SchedQueueDepth(LCD1602_I2C_Sched_t* sched){
+    __UINT16_TYPE__ depth = 0;
+
+    for(__UINT8_TYPE__ i = 0; i < sched->count; i++){
+        depth += LCD1602_I2C_AsyncQueueDepth(sched->displays[i]);
+    }
+    return depth;
+}
+
+
+#if LCD1602_I2C_TRACE
+void LCD1602_I2C_TraceStats(LCD1602_I2C_t* lcd, LCD1602_I2C_TraceStats_t* stats){
+    memcpy(stats, &lcd->trace, sizeof(*stats));
+}
+
+
+void LCD1602_I2C_TraceReset(LCD1602_I2C_t* lcd){
+    memset(&lcd->trace, 0, sizeof(lcd->trace));
+}
+
+
+__UINT16_TYPE__ LCD1602_I2C_TraceRead(LCD1602_I2C_t* lcd, __UINT32_TYPE__* cursor, LCD1602_I2C_TraceEntry_t* entries, __UINT16_TYPE__ max){
+    __UINT32_TYPE__ head = lcd->traceHead;
+    __UINT32_TYPE__ from = *cursor;
+    __UINT32_TYPE__ safe = 0;
+    __UINT16_TYPE__ count = 0;
+
+    LCD1602_I2C_MEMORY_BARRIER(); // Pairs with the barrier of LCD1602_I2C_TraceBus
+    if(head - from >= LCD1602_I2C_TRACE_DEPTH) from = (head >= LCD1602_I2C_TRACE_DEPTH) ? head + 1 - LCD1602_I2C_TRACE_DEPTH : 0; // Overwritten already (or a cursor of an earlier init), the oldest slot is the next one written
+    while(from + count != head && count < max){
+        entries[count] = lcd->traceRing[(from + count) & (LCD1602_I2C_TRACE_DEPTH - 1)];
+        count++;
+    }
+    LCD1602_I2C_MEMORY_BARRIER();
+
+    // The driver may have lapped the copy meanwhile, only entries above the one it writes next are intact
+    head = lcd->traceHead;
+    safe = (head + 1 > LCD1602_I2C_TRACE_DEPTH) ? head + 1 - LCD1602_I2C_TRACE_DEPTH : 0;
+    if(from < safe){
+        __UINT32_TYPE__ lost = safe - from;
+        if(lost > count) lost = count;
+        memmove(entries, &entries[lost], (count - lost) * sizeof(*entries));
+        count -= (__UINT16_TYPE__)lost;
+        from = safe;
     }
-    return LCD1602_I2C_CursorDisplayShift(1, right);
+    *cursor = from + count;
+    return count;
 }
+#endif
 
 
 // Test functions definition
-void test_lcd_i2c_display_shift(void){
-    LCD1602_I2C_CursorDisplayShift(1, 0); // Shift display left
-    HAL_Delay(400);
+void test_lcd_i2c_display_shift(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_CursorDisplayShift(lcd, 1, 0); // Shift display left
+    LCD1602_I2C_DelayUs(lcd, 400000);
 }
 
-void test_lcd_i2c_cursor_shift(void){
-    LCD1602_I2C_CursorDisplayShift(0, 1); // Move cursor right
-    HAL_Delay(400);
+void test_lcd_i2c_cursor_shift(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_CursorDisplayShift(lcd, 0, 1); // Move cursor right
+    LCD1602_I2C_DelayUs(lcd, 400000);
 }
 
-void test_lcd_i2c_char_write_spam(void){
+void test_lcd_i2c_char_write_spam(LCD1602_I2C_t* lcd){
     for(__UINT8_TYPE__ i = 0; i < 100; i++){
-        LCD1602_I2C_Write_Data('A' + (i % 26));
-        HAL_Delay(200);
+        LCD1602_I2C_Write_Data(lcd, 'A' + (i % 26));
+        LCD1602_I2C_DelayUs(lcd, 200000);
     }
 }
 
-void test_lcd_i2c_ddram_addressing(void){
-    LCD1602_I2C_SetDDRAMAddress(0x0A);
-    LCD1602_I2C_Write_Data('X');
+void test_lcd_i2c_ddram_addressing(LCD1602_I2C_t* lcd){
+    LCD1602_I2C_SetDDRAMAddress(lcd, 0x0A);
+    LCD1602_I2C_Write_Data(lcd, 'X');
 }
 
-void test_lcd_i2c_busy_flag_address(__UINT8_TYPE__* address){
-    LCD1602_I2C_Read_BusyFlag_Address(address);
+void test_lcd_i2c_busy_flag_address(LCD1602_I2C_t* lcd, __UINT8_TYPE__* address){
+    LCD1602_I2C_Read_BusyFlag_Address(lcd, address);
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
  * @date: 19/01/2026
  * @reference: https://cdn.sparkfun.com/assets/9/5/f/7/b/HD44780.pdf
  * @reference: https://file.thegioiic.com/upload/documents/1740390659_PCF8574AT-3,518.pdf
- * @brief: This is a basic driver for an LCD1602 using PCF8574 I2C module to communicate with STM32, you can replace the communicating functions if needed. Just search for Hardware Abstract Layer functions, status, etc. of STM32 and replace it with your communicating functions.
+ * @brief: This is a basic driver for an LCD1602 using PCF8574 I2C module. The bus is reached through a LCD1602_I2C_Transport_t, backends for STM32 HAL (lcd_i2c_stm32.h), Linux i2c-dev (lcd_i2c_linux.h) and a host mock (lcd_i2c_mock.h) are provided, you can write your own for other platforms.
  */
 
 
@@ -11,14 +11,86 @@
 #define LCD_I2C_H
 
 // Additional library includes
-#include "main.h"
 
 // Macros
 //// Device address
-#define PCF8574_ADDRESS 0x4E // The address of PCF8574, ranges from 0x40 to 0x4E, the LSB is R/~W bit
+#define PCF8574_ADDRESS 0x4E // Default address of PCF8574, ranges from 0x40 to 0x4E, the LSB is R/~W bit (A0..A2 straps select the other 7)
+
+//// Burst buffer
+#ifndef LCD1602_I2C_BURST_FRAMES
+#define LCD1602_I2C_BURST_FRAMES 160 // PCF8574 frames sent per I2C transaction at most, 4 frames per instruction/data (default fits a full 40 characters line)
+#endif
+
+//// Timing
+#ifndef LCD1602_I2C_BUS_KHZ
+#define LCD1602_I2C_BUS_KHZ 100 // Default I2C clock, used to know how long a transfer takes to reach the LCD (per display through LCD1602_I2C_Init)
+#endif
+#define LCD1602_I2C_LATCH_LEAD_US (27000 / LCD1602_I2C_BUS_KHZ) // Time from START to the first nibble being latched (address byte + 2 frames)
+#ifndef LCD1602_I2C_POWER_ON_US
+#define LCD1602_I2C_POWER_ON_US 40000 // The LCD1602 needs 40ms after Vcc rises to 2.7V, counted from timestamp 0
+#endif
+
+//// Busy flag polling
+#ifndef LCD1602_I2C_BUSY_POLL_MAX
+#define LCD1602_I2C_BUSY_POLL_MAX 100 // Busy flag reads before giving up with LCD1602_I2C_TIMEOUT (a read takes about 0.5ms at 100kHz)
+#endif
+
+//// Bounded latency
+#ifndef LCD1602_I2C_TIMEOUT_SLACK_US
+#define LCD1602_I2C_TIMEOUT_SLACK_US 1000 // Added to the wire time of a transaction to get the timeout passed to the transport (interrupt latency, clock stretching)
+#endif
+
+//// Asynchronous transmit queue
+#ifndef LCD1602_I2C_ASYNC_DEPTH
+#define LCD1602_I2C_ASYNC_DEPTH 8 // Number of entries in the transmit ring, one entry is always kept free
+#endif
+#ifndef LCD1602_I2C_ASYNC_ENTRY_FRAMES
+#define LCD1602_I2C_ASYNC_ENTRY_FRAMES 64 // PCF8574 frames per entry, longer bursts span several entries
+#endif
+#ifndef LCD1602_I2C_SCHED_DISPLAYS
+#define LCD1602_I2C_SCHED_DISPLAYS 8 // Displays one bus scheduler can serve (8 PCF8574 addresses per bus)
+#endif
+#ifndef LCD1602_I2C_ENTER_CRITICAL
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_BASE__) || defined(__ARM_ARCH_8M_MAIN__)
+#define LCD1602_I2C_ENTER_CRITICAL() __UINT32_TYPE__ lcdPrimask; __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (lcdPrimask) :: "memory")
+#define LCD1602_I2C_EXIT_CRITICAL() __asm volatile ("msr primask, %0" :: "r" (lcdPrimask) : "memory")
+#else
+#define LCD1602_I2C_ENTER_CRITICAL() // Hosts complete transfers from the calling thread, override if completions run on another thread
+#define LCD1602_I2C_EXIT_CRITICAL()
+#endif
+#endif
+
+//// Region mailboxes
+#ifndef LCD1602_I2C_REGIONS
+#define LCD1602_I2C_REGIONS 8 // Regions one display can refresh
+#endif
+#ifndef LCD1602_I2C_REGION_CHARS
+#define LCD1602_I2C_REGION_CHARS 16 // Characters one region holds at most
+#endif
+#ifndef LCD1602_I2C_MEMORY_BARRIER
+#define LCD1602_I2C_MEMORY_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST) // Orders the region sequence counter against its text (compiler and CPU, dmb on Cortex-M)
+#endif
+
+//// Warm start
+#ifndef LCD1602_I2C_NOINIT
+#define LCD1602_I2C_NOINIT __attribute__((section(".noinit"))) // Keeps a context out of the RAM zeroed at startup (the linker script needs a NOLOAD .noinit section), for LCD1602_I2C_WarmStart
+#endif
+
+//// UTF-8 text
+#ifndef LCD1602_I2C_UTF8_REPLACEMENT
+#define LCD1602_I2C_UTF8_REPLACEMENT '?' // Character code shown for invalid UTF-8 and for characters found neither in the character ROM nor in the UTF-8 glyph table
+#endif
+
+//// Instrumentation
+#ifndef LCD1602_I2C_TRACE
+#define LCD1602_I2C_TRACE 0 // Set to 1 to count the bus traffic and the time of each public call and keep the last frames in a trace ring (LCD1602_I2C_TraceStats, LCD1602_I2C_TraceRead), 0 compiles every hook out
+#endif
+#ifndef LCD1602_I2C_TRACE_DEPTH
+#define LCD1602_I2C_TRACE_DEPTH 64 // Entries of the trace ring, a power of 2 (the last LCD1602_I2C_TRACE_DEPTH - 1 bytes can be read, the oldest slot is the next one written)
+#endif
 
 /*
- * Pin mask of the 8-bit value sent to the LCD
+ * Pin mask of the 8-bit value sent to the LCD (default wiring, every *_INDEX_PIN below can be overridden at build time, e.g. -DRS_INDEX_PIN=6, for backpacks wired differently)
  * | Bit | Pin | Signal | Description        |
  * |-----|-----|--------|--------------------|
  * | 0   | P0  | RS     | Register Select    |
@@ -31,14 +103,30 @@
  * | 7   | P7  | DB7,DB3| Data Bit 7         |
 */
 
+#ifndef RS_INDEX_PIN
 #define RS_INDEX_PIN 0
+#endif
+#ifndef RW_INDEX_PIN
 #define RW_INDEX_PIN 1
+#endif
+#ifndef EN_INDEX_PIN
 #define EN_INDEX_PIN 2
+#endif
+#ifndef BL_INDEX_PIN
 #define BL_INDEX_PIN 3
+#endif
+#ifndef DB4_INDEX_PIN
 #define DB4_INDEX_PIN 4
+#endif
+#ifndef DB5_INDEX_PIN
 #define DB5_INDEX_PIN 5
+#endif
+#ifndef DB6_INDEX_PIN
 #define DB6_INDEX_PIN 6
+#endif
+#ifndef DB7_INDEX_PIN
 #define DB7_INDEX_PIN 7
+#endif
 #define DB0_INDEX_PIN DB4_INDEX_PIN
 #define DB1_INDEX_PIN DB5_INDEX_PIN
 #define DB2_INDEX_PIN DB6_INDEX_PIN
@@ -57,6 +145,36 @@
 #define PIN_DB2 (1 << DB2_INDEX_PIN)
 #define PIN_DB3 (1 << DB3_INDEX_PIN)
 
+#define LCD1602_I2C_NIBBLE_PINS(n) ((((n) & 0x1) ? PIN_DB4 : 0) | (((n) & 0x2) ? PIN_DB5 : 0) | (((n) & 0x4) ? PIN_DB6 : 0) | (((n) & 0x8) ? PIN_DB7 : 0)) // Put a 4-bit value on DB4..DB7
+
+_Static_assert((PIN_RS | PIN_RW | PIN_EN | PIN_BL | PIN_DB4 | PIN_DB5 | PIN_DB6 | PIN_DB7) == 0xFF, "Each PCF8574 pin must be mapped to exactly one LCD signal");
+
+/*
+ * Pin mask of the 16-bit value sent to a PCF8575 (LCD1602_I2C_InitExpander with LCD1602_I2C_PCF8575), the HD44780U runs in 8-bit mode
+ * - Port 0 (P00..P07, first byte of each port write): DB0..DB7
+ * - Port 1 (P10..P17, second byte): RS, R/W, EN and BL on the bits below (overridable like the PCF8574 ones), the other 4 pins are left high
+ */
+#ifndef PCF8575_RS_INDEX_PIN
+#define PCF8575_RS_INDEX_PIN 0
+#endif
+#ifndef PCF8575_RW_INDEX_PIN
+#define PCF8575_RW_INDEX_PIN 1
+#endif
+#ifndef PCF8575_EN_INDEX_PIN
+#define PCF8575_EN_INDEX_PIN 2
+#endif
+#ifndef PCF8575_BL_INDEX_PIN
+#define PCF8575_BL_INDEX_PIN 3
+#endif
+
+#define PCF8575_PIN_RS (1 << PCF8575_RS_INDEX_PIN)
+#define PCF8575_PIN_RW (1 << PCF8575_RW_INDEX_PIN)
+#define PCF8575_PIN_EN (1 << PCF8575_EN_INDEX_PIN)
+#define PCF8575_PIN_BL (1 << PCF8575_BL_INDEX_PIN)
+#define PCF8575_PINS_UNUSED (0xFF & ~(PCF8575_PIN_RS | PCF8575_PIN_RW | PCF8575_PIN_EN | PCF8575_PIN_BL))
+
+_Static_assert((LCD1602_I2C_BURST_FRAMES % 2) == 0 && (LCD1602_I2C_ASYNC_ENTRY_FRAMES % 2) == 0, "A PCF8575 port write is 2 bytes, transactions must not split one");
+
 /**
  * CMD Syntax
  * - [RS][R/~W][DB7][DB6][DB5][DB4][DB3][DB2][DB1][DB0]
@@ -86,63 +204,801 @@
 #define MSK_DB1 (1 << DB1_INDEX_MSK)
 #define MSK_DB0 (1 << DB0_INDEX_MSK)
 
-// Status typedef
-typedef HAL_StatusTypeDef LCD1602_I2C_Status_t;
+#define LCD1602_I2C_AC_UNKNOWN 0xFF // Address counter value when the driver does not know where the HD44780U points
+#define LCD1602_I2C_AC_CGRAM 0x80 // Set in the address counter value while it points into CGRAM, the lower 6 bits are the CGRAM address
+#define LCD1602_I2C_GLYPH_NONE 0xFFFF // Glyph id of a CGRAM character or shadow cell that holds no registered glyph
+#define LCD1602_I2C_GLYPH_UTF8 0x8000 // Set in the glyph id of an entry of the UTF-8 glyph table (LCD1602_I2C_SetUtf8Glyphs), the lower 15 bits are its index
+#define LCD1602_I2C_TRACE_WRITE 0x00 // Trace entry of a byte written by a blocking call
+#define LCD1602_I2C_TRACE_READ 0x01 // Trace entry of a byte read
+#define LCD1602_I2C_TRACE_PROBE 0x02 // Trace entry of an address only transaction, frame is 0
+#define LCD1602_I2C_TRACE_ASYNC 0x03 // Trace entry of a byte of a queued transfer, started by the asynchronous drain (logged when the transfer starts)
+#define LCD1602_I2C_TRACE_KIND 0x03 // Mask of the kind in the flags of a trace entry
+#define LCD1602_I2C_TRACE_START 0x40 // Set in the flags of the first byte of a transaction
+#define LCD1602_I2C_TRACE_FAILED 0x80 // Set in the flags of the bytes of a transaction that failed (or could not be started)
+#define LCD1602_I2C_WARM_MAGIC 0x4C434457UL // Marks an initialized context, combined with its size so the context of another build is not taken for one
+
+// Status typedef, the values up to LCD1602_I2C_TIMEOUT match HAL_StatusTypeDef of STM32 HAL
+typedef enum {
+    LCD1602_I2C_OK = 0x00,
+    LCD1602_I2C_ERROR = 0x01,
+    LCD1602_I2C_BUSY = 0x02,
+    LCD1602_I2C_TIMEOUT = 0x03, // The transport timed out, or the busy flag never cleared
+    LCD1602_I2C_NACK = 0x04, // The PCF8574 did not acknowledge (unplugged, wrong address)
+    LCD1602_I2C_BUS_ERROR = 0x05, // Bus error or arbitration lost, e.g. SDA held low by a slave
+    LCD1602_I2C_DEADLINE = 0x06 // Not started because it would not end within the budget of the call (LCD1602_I2C_SetBudget)
+} LCD1602_I2C_Status_t;
+
+// Expander typedef
+typedef enum {
+    LCD1602_I2C_PCF8574 = 0, // 8-bit expander, the HD44780U runs in 4-bit mode: 4 port writes (4 bytes) per instruction/data
+    LCD1602_I2C_PCF8575 = 1 // 16-bit expander, the HD44780U runs in 8-bit mode: 2 port writes (4 bytes) per instruction/data
+} LCD1602_I2C_Expander_t;
+
+// Character ROM typedef, the part number suffix of the HD44780U (A00 on most LCD1602 modules)
+typedef enum {
+    LCD1602_I2C_ROM_A00 = 0, // Japanese: ASCII except backslash (yen sign) and tilde (right arrow), katakana, a few Greek and accented letters
+    LCD1602_I2C_ROM_A02 = 1 // European: ASCII and most of Latin-1 (accented letters, degree sign)
+} LCD1602_I2C_Rom_t;
+
+// Geometry typedef, columns x rows of the module (LCD1602_I2C_SetGeometry)
+/*
+ * 2 and 4 rows displays run the HD44780U in 2 lines mode: each DDRAM line holds 40 characters and is shifted as a whole
+ * - 1 row displays run it in 1 line mode (1/8 duty), one DDRAM line of 80 characters (0x00..0x4F) shifted as a whole
+ * - 1 and 2 rows displays show the start of the lines, x goes up to 39 to reach the columns a display shift brings in
+ * - 4 rows displays show rows 2 and 3 on the rest of lines 0 and 1 (20x4: 0x00, 0x40, 0x14, 0x54), x goes up to columns - 1
+ */
+typedef enum {
+    LCD1602_I2C_16X2 = 0, // Default
+    LCD1602_I2C_16X1 = 1, // Single line wiring (0x00..0x0F), a module wired as 8x2 is driven as LCD1602_I2C_16X2 with its right half on row 1
+    LCD1602_I2C_16X4 = 2,
+    LCD1602_I2C_20X2 = 3,
+    LCD1602_I2C_20X4 = 4,
+    LCD1602_I2C_40X2 = 5
+} LCD1602_I2C_Geometry_t;
+
+// Transport segment typedef
+typedef struct {
+    __UINT8_TYPE__* data; // Bytes to write, or storage for the bytes read
+    __UINT16_TYPE__ length; // Number of bytes
+    __UINT8_TYPE__ read; // 1 for a read message, 0 for a write message
+} LCD1602_I2C_Segment_t;
+
+// Transport typedef
+/*
+ * Bus backend used by the driver, every function gets the bus handle given to LCD1602_I2C_Init
+ * - Addresses are in the 8-bit form (R/~W bit included, e.g. 0x4E), as used by STM32 HAL
+ * - write/read/probe must give up after timeoutUs (rounded up to the backend clock) and report the failure as LCD1602_I2C_NACK, _BUS_ERROR or _TIMEOUT when they can tell them apart
+ * - Backends: LCD1602_I2C_Transport_STM32 (lcd_i2c_stm32.h), LCD1602_I2C_Transport_Linux (lcd_i2c_linux.h), LCD1602_I2C_Transport_Mock (lcd_i2c_mock.h)
+ */
+typedef struct {
+    LCD1602_I2C_Status_t (*write)(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs); // One write transaction
+    LCD1602_I2C_Status_t (*read)(void* bus, __UINT8_TYPE__ address, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs); // One read transaction
+    LCD1602_I2C_Status_t (*probe)(void* bus, __UINT8_TYPE__ address, __UINT32_TYPE__ timeoutUs); // LCD1602_I2C_OK if the device acknowledges its address, a single attempt
+    void (*delayUs)(void* bus, __UINT32_TYPE__ us); // Blocking delay of at least us microseconds
+    __UINT32_TYPE__ (*micros)(void* bus); // Free running timestamp in us, wrapping at 2^32
+    LCD1602_I2C_Status_t (*writeAsync)(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length); // Optional (0), starts a write and reports its end through LCD1602_I2C_AsyncTxComplete/LCD1602_I2C_AsyncTxError
+    LCD1602_I2C_Status_t (*recover)(void* bus); // Optional (0), frees a bus held by a slave (9 SCL clocks then a STOP) and resets the I2C peripheral
+    LCD1602_I2C_Status_t (*transfer)(void* bus, __UINT8_TYPE__ address, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count, __UINT32_TYPE__ timeoutUs); // Optional (0), the messages of a busy flag/data read as one transaction with a repeated START between them, otherwise they are sent with write/read one by one
+    __UINT16_TYPE__ timeResolutionUs; // How late micros may be, added to every deadline
+} LCD1602_I2C_Transport_t;
+
+// Asynchronous transmit queue typedefs
+typedef enum {
+    LCD1602_I2C_ASYNC_IDLE = 0, // Nothing on the bus, the next entry can be started
+    LCD1602_I2C_ASYNC_TRANSMITTING, // An entry is being sent by the I2C interrupt/DMA
+    LCD1602_I2C_ASYNC_SETTLING // The entry is sent, waiting for the LCD1602 to execute it
+} LCD1602_I2C_AsyncState_t;
+
+typedef struct {
+    __UINT8_TYPE__ frames[LCD1602_I2C_ASYNC_ENTRY_FRAMES]; // Encoded PCF8574 frames
+    __UINT16_TYPE__ length; // Number of valid frames
+    __UINT16_TYPE__ settleUs; // Execution time to wait after the frames are sent, in us
+    __UINT8_TYPE__ isLast; // Set on the last entry of an asynchronous call, the completion callback fires after it
+} LCD1602_I2C_AsyncEntry_t;
+
+typedef struct LCD1602_I2C LCD1602_I2C_t;
+typedef struct LCD1602_I2C_Sched LCD1602_I2C_Sched_t;
+
+/**
+ * @brief Called once per asynchronous call, after its last transfer is sent and executed (or dropped on error)
+ * @param lcd: The display the call was made on
+ * @param status: LCD1602_I2C_OK on success, LCD1602_I2C_ERROR if a transfer of the call failed
+ */
+typedef void (*LCD1602_I2C_AsyncCallback_t)(LCD1602_I2C_t* lcd, LCD1602_I2C_Status_t status);
+
+// Glyph typedef
+/*
+ * 5x8 custom character, one byte per pixel row from top to bottom, bit 4 is the leftmost pixel (bits 5..7 are ignored)
+ * - The application keeps a table of any number of glyphs, the 8 CGRAM characters of the LCD1602 cache the ones in use
+ */
+typedef __UINT8_TYPE__ LCD1602_I2C_Glyph_t[8];
+
+// UTF-8 glyph typedef
+/*
+ * Bitmap drawn for a character the character ROM does not have, the table given to LCD1602_I2C_SetUtf8Glyphs is sorted by codepoint
+ * - The entries share the 8 CGRAM characters with the glyphs of LCD1602_I2C_SetGlyphs
+ */
+typedef struct {
+    __UINT32_TYPE__ codepoint; // Unicode codepoint
+    LCD1602_I2C_Glyph_t glyph;
+} LCD1602_I2C_Utf8Glyph_t;
+
+// UTF-8 decoder typedef
+typedef struct {
+    __UINT32_TYPE__ codepoint; // Bits of the sequence decoded so far
+    __UINT8_TYPE__ pending; // Continuation bytes still expected, 0 between characters
+    __UINT8_TYPE__ length; // Continuation bytes of the sequence, tells an overlong encoding
+} LCD1602_I2C_Utf8Decoder_t;
+
+// Region typedef
+/*
+ * Mailbox holding the latest text of a part of one row, posted by its producer and copied into the shadow framebuffer by LCD1602_I2C_Refresh
+ * - Lock-free (sequence lock): posting never waits, on the bus or on the refresh task. Posts made between two refreshes collapse into the last one.
+ * - One producer per region (a task or an interrupt), several producers post to their own regions concurrently
+ * - The refresh skips a region while its producer is in the middle of a post, the text is picked up by the next refresh
+ */
+typedef struct {
+    volatile __UINT32_TYPE__ sequence; // Incremented before and after the text is written, odd while a post is in progress
+    volatile __UINT8_TYPE__ text[LCD1602_I2C_REGION_CHARS]; // Latest text posted, padded with spaces to the region width
+    __UINT32_TYPE__ applied; // Sequence of the text last copied into the shadow framebuffer, owned by the refresh
+    __UINT8_TYPE__ x; // First column on the shadow framebuffer line (0 to 39)
+    __UINT8_TYPE__ y; // Shadow framebuffer line (0 or 1), the DDRAM line of the row
+    __UINT8_TYPE__ width; // Number of columns, 1 to LCD1602_I2C_REGION_CHARS
+} LCD1602_I2C_Region_t;
+
+// Instrumented public call typedef
+/*
+ * Index of the counters of a public call in LCD1602_I2C_TraceStats_t
+ * - A call made inside another public call counts toward the outer one (LCD1602_I2C_Refresh includes its flush)
+ * - Asynchronous variants count toward their blocking call, the time is the time to capture the call, not to send it
+ */
+typedef enum {
+    LCD1602_I2C_API_INIT = 0, // LCD1602_I2C_Init, LCD1602_I2C_InitExpander
+    LCD1602_I2C_API_WARM_START,
+    LCD1602_I2C_API_CLEAR,
+    LCD1602_I2C_API_MOVE_CURSOR,
+    LCD1602_I2C_API_SHOW_CHAR,
+    LCD1602_I2C_API_SHOW_STRING,
+    LCD1602_I2C_API_SHOW_WRAPPED,
+    LCD1602_I2C_API_SHOW_UTF8,
+    LCD1602_I2C_API_SHOW_GLYPH,
+    LCD1602_I2C_API_PRINTF,
+    LCD1602_I2C_API_SHIFT_DISPLAY,
+    LCD1602_I2C_API_SET_ENTRY_MODE,
+    LCD1602_I2C_API_SET_BACKLIGHT,
+    LCD1602_I2C_API_FLUSH,
+    LCD1602_I2C_API_REFRESH,
+    LCD1602_I2C_API_MARQUEE_START,
+    LCD1602_I2C_API_MARQUEE_STEP,
+    LCD1602_I2C_API_RECOVER,
+    LCD1602_I2C_API_SCRUB,
+    LCD1602_I2C_API_COUNT // Number of instrumented calls
+} LCD1602_I2C_Api_t;
+
+// Trace counters typedef
+/*
+ * Counters of one display kept with LCD1602_I2C_TRACE, from LCD1602_I2C_Init on (kept across LCD1602_I2C_WarmStart)
+ * - busUs and delayUs tell the time on the wire (and in the transport) from the fixed waits of the timing model, the rest of a call is CPU time
+ * - Queued transfers are counted when the drain starts them, their time is not in busUs
+ */
+typedef struct {
+    __UINT32_TYPE__ transactions; // I2C transactions started, probes included
+    __UINT32_TYPE__ bytes; // Data bytes written and read, address bytes excluded
+    __UINT32_TYPE__ probes; // Address only transactions, during a bus recovery and LCD1602_I2C_WarmStart
+    __UINT32_TYPE__ retries; // Busy flag reads that found the LCD1602 busy, and bus recoveries started (again)
+    __UINT32_TYPE__ errors; // Transactions that failed or could not be started, deadline misses excluded
+    __UINT32_TYPE__ busUs; // Time spent in the blocking transport write/read/probe calls
+    __UINT32_TYPE__ delayUs; // Time spent in the fixed waits (execution times, power-on sequence)
+    __UINT32_TYPE__ apiCalls[LCD1602_I2C_API_COUNT]; // Calls made by the application, indexed by LCD1602_I2C_Api_t
+    __UINT32_TYPE__ apiUs[LCD1602_I2C_API_COUNT]; // Cumulative time of these calls
+    __UINT32_TYPE__ apiMaxUs[LCD1602_I2C_API_COUNT]; // Longest of these calls
+} LCD1602_I2C_TraceStats_t;
+
+// Trace entry typedef
+typedef struct {
+    __UINT32_TYPE__ timestamp; // Timestamp (us) at which the transaction started
+    __UINT8_TYPE__ frame; // Byte on the bus (PCF8574 frame or PCF8575 port value), 0 for a probe
+    __UINT8_TYPE__ flags; // LCD1602_I2C_TRACE_WRITE/_READ/_PROBE/_ASYNC, with LCD1602_I2C_TRACE_START and LCD1602_I2C_TRACE_FAILED
+} LCD1602_I2C_TraceEntry_t;
+
+// Display context typedef
+/*
+ * Every piece of driver state of one display, each display gets its own instance (static storage, about 1.3KB with the default sizes, 0.8KB more with LCD1602_I2C_TRACE)
+ * - Filled by LCD1602_I2C_Init, the fields are private to the driver
+ * - Displays share no mutable state, so displays on different buses can be driven from different threads/interrupts in parallel
+ * - One context must only be used by one thread at a time, and asynchronous calls of displays sharing a bus must not overlap
+ */
+struct LCD1602_I2C {
+    const LCD1602_I2C_Transport_t* transport; // Bus backend, see LCD1602_I2C_Transport_t
+    void* bus; // Bus handle passed to every transport function
+    __UINT8_TYPE__ address; // Expander address, 8-bit form (0x40 to 0x4E)
+    __UINT8_TYPE__ expander; // LCD1602_I2C_Expander_t, selects the frame encoding and the interface width of the HD44780U
+    __UINT8_TYPE__ columns; // Visible columns per row
+    __UINT8_TYPE__ rows; // Visible rows, 1 to 4
+    __UINT8_TYPE__ rowStart[4]; // DDRAM address of the first column of each row, copied from the geometry table
+    __UINT8_TYPE__ twoLines; // Function set N, copied from the geometry table: 1 for two 40 characters DDRAM lines, 0 for one 80 characters line
+    __UINT8_TYPE__ backlight; // Backlight state, added to every frame sent
+    __UINT8_TYPE__ displayOffset; // Display shift in columns, 0 to 39, 0 to 79 in 1 line mode (1 after one shift right)
+    __UINT8_TYPE__ ac; // Address counter as the driver knows it: DDRAM address, LCD1602_I2C_AC_CGRAM | CGRAM address, or LCD1602_I2C_AC_UNKNOWN after a failed transfer
+    __UINT8_TYPE__ increment; // Entry mode I/D
+    __UINT8_TYPE__ entryShift; // Entry mode S
+    __UINT8_TYPE__ dataRegisterValid; // Set by address sets, cursor shifts and reads, cleared by data writes: the HD44780U data register then holds the written byte, a read must follow an address set
+    __UINT8_TYPE__ asyncSaved[4]; // ac, displayOffset, increment and entryShift before the call being captured, restored if it is not queued
+    __UINT16_TYPE__ asyncSavedGlyphSlot[8]; // glyphSlot and glyphLru before the call being captured, restored if it is not queued
+    __UINT8_TYPE__ asyncSavedGlyphLru[8];
+    const char* asyncSavedMarqueeText[2]; // marqueeText and marqueePos before the call being captured, restored if it is not queued
+    __UINT16_TYPE__ asyncSavedMarqueePos[2];
+    __UINT8_TYPE__ burstFrames[LCD1602_I2C_BURST_FRAMES]; // Encoded PCF8574 frames waiting to be sent in one transaction
+    __UINT16_TYPE__ burstLength; // Number of valid frames in burstFrames
+    __UINT8_TYPE__ burstHold; // While non-zero, LCD1602_I2C_SendToLCD only queues frames instead of sending them
+    __UINT8_TYPE__ shadow[2][40]; // Content requested by the application, indexed by [line][column] as seen on the display (rows 2 and 3 continue lines 0 and 1)
+    __UINT8_TYPE__ ddram[2][40]; // Content believed to be in DDRAM, indexed by [line][address & 0x3F], by [address / 40][address % 40] in 1 line mode
+    __UINT8_TYPE__ ddramValid; // Set to 0 when DDRAM was written outside of LCD1602_I2C_Flush, the next flush then redraws every cell
+    __UINT16_TYPE__ shadowGlyph[2][40]; // Glyph id drawn in each shadow cell, LCD1602_I2C_GLYPH_NONE for plain characters
+    const LCD1602_I2C_Glyph_t* glyphs; // Glyph table registered with LCD1602_I2C_SetGlyphs, owned by the application
+    __UINT16_TYPE__ glyphCount; // Number of glyphs in the table
+    __UINT16_TYPE__ glyphSlot[8]; // Glyph id held by each CGRAM character, LCD1602_I2C_GLYPH_NONE when free or unknown
+    __UINT8_TYPE__ glyphLru[8]; // CGRAM characters from the most to the least recently used
+    __UINT32_TYPE__ glyphHits; // Glyph draws served by a CGRAM character already holding the glyph
+    __UINT32_TYPE__ glyphMisses; // Glyph draws that needed an upload
+    const char* marqueeText[2]; // Text scrolled on each row by LCD1602_I2C_MarqueeStep, 0 when the row is not a marquee
+    __UINT16_TYPE__ marqueeLength[2]; // Length of the text
+    __UINT16_TYPE__ marqueePos[2]; // Index of the text character shown in the first display column
+    LCD1602_I2C_AsyncEntry_t asyncQueue[LCD1602_I2C_ASYNC_DEPTH]; // Ring of encoded transfers waiting for the interrupt driven drain
+    volatile __UINT8_TYPE__ asyncHead; // Next entry visible to the drain, only moved by the application
+    volatile __UINT8_TYPE__ asyncTail; // Entry being sent or next to send, only moved by the drain
+    __UINT8_TYPE__ asyncStage; // Next free entry of the call being captured, published to asyncHead when the call ends
+    __UINT8_TYPE__ asyncCapture; // While non-zero, committed bursts and waits are staged in the queue instead of being performed
+    volatile LCD1602_I2C_AsyncState_t asyncState;
+    volatile __UINT32_TYPE__ asyncSettleStart; // Timestamp (us) at which the current settle time started
+    LCD1602_I2C_AsyncCallback_t asyncCallback;
+    __UINT8_TYPE__ busyPolling; // Set to 1 to wait on the busy flag instead of fixed delays
+    __UINT8_TYPE__ busyPending; // Set when an instruction may still be executing, the next access polls the busy flag first
+    __UINT32_TYPE__ readyAt; // Timestamp (us) from which the LCD1602 accepts the next instruction, starts with the power-on time
+    __UINT16_TYPE__ lastExecUs; // Execution time of the last instruction/data encoded in the burst buffer
+    __UINT16_TYPE__ busKhz; // SCL clock of this bus
+    __UINT16_TYPE__ latchLeadUs; // LCD1602_I2C_LATCH_LEAD_US for the clock of this bus (address byte + 4 bytes with a PCF8575)
+    __UINT32_TYPE__ budgetUs; // Longest time one blocking call may take, 0 for no limit (LCD1602_I2C_SetBudget)
+    __UINT32_TYPE__ deadline; // Timestamp (us) the running call must be done by
+    __UINT8_TYPE__ deadlineOwner; // 0: no deadline, 1: set by the outermost burst, 2: set by a single commit or LCD1602_I2C_Recover
+    __UINT8_TYPE__ recoverStep; // Next step of the bus recovery and resynchronization after a failure, 0 when in sync
+    LCD1602_I2C_Region_t* regions[LCD1602_I2C_REGIONS]; // Mailboxes read by LCD1602_I2C_Refresh, owned by the application
+    __UINT8_TYPE__ regionCount; // Number of attached regions
+    __UINT8_TYPE__ refreshPending; // Set when the shadow framebuffer holds region text (or the DDRAM content was lost) that no flush has sent yet
+    __UINT32_TYPE__ framePeriodUs; // Shortest time between two refreshes sending something, 0 for no limit (LCD1602_I2C_SetFrameRate)
+    __UINT32_TYPE__ lastFrame; // Timestamp (us) of the last refresh that sent something
+    LCD1602_I2C_Sched_t* sched; // Bus scheduler sending the queued transfers, 0 when the display drives the bus itself
+    __UINT8_TYPE__ writing; // Set while a write transaction is under way, a reset meanwhile leaves DDRAM unknown
+    __UINT8_TYPE__ scrubPos; // Next cell LCD1602_I2C_Scrub reads back, line * 40 + address & 0x3F
+    __UINT32_TYPE__ scrubChecked; // Cells read back by LCD1602_I2C_Scrub
+    __UINT32_TYPE__ scrubCorrupted; // Cells read back with another character than DDRAM should hold, rewritten
+    __UINT8_TYPE__ rom; // LCD1602_I2C_Rom_t, selects the table mapping UTF-8 text to character codes
+    const LCD1602_I2C_Utf8Glyph_t* utf8Glyphs; // Glyphs drawn for the characters missing from the character ROM, sorted by codepoint (LCD1602_I2C_SetUtf8Glyphs)
+    __UINT16_TYPE__ utf8GlyphCount; // Number of entries in the table
+    LCD1602_I2C_Utf8Decoder_t utf8; // Sequence LCD1602_I2C_ShowUtf8 is in the middle of, continued by the next call
+#if LCD1602_I2C_TRACE
+    LCD1602_I2C_TraceStats_t trace; // Counters read by LCD1602_I2C_TraceStats
+    __UINT8_TYPE__ traceDepth; // Public calls in progress, the outermost one is timed
+    LCD1602_I2C_TraceEntry_t traceRing[LCD1602_I2C_TRACE_DEPTH]; // Last bytes on the bus, entry traceHead % LCD1602_I2C_TRACE_DEPTH is the next one written
+    volatile __UINT32_TYPE__ traceHead; // Bytes logged since LCD1602_I2C_Init, only moved by the driver once the entry is written
+#endif
+    __UINT32_TYPE__ warmMagic; // LCD1602_I2C_WARM_MAGIC ^ sizeof(LCD1602_I2C_t) once initialized, checked by LCD1602_I2C_WarmStart
+};
+
+// Bus scheduler typedef
+/*
+ * Shares one bus between the asynchronous queues of several displays
+ * - Whenever the bus is free, the next display (round-robin) whose queue has a transfer and whose last instruction is executed gets the bus
+ * - A display waiting for an execution time (e.g. 1.52ms after a clear) is skipped until its deadline, so the other displays use the bus meanwhile
+ * - Displays are attached once initialized, only the asynchronous calls may be used on them afterwards
+ */
+struct LCD1602_I2C_Sched {
+    LCD1602_I2C_t* displays[LCD1602_I2C_SCHED_DISPLAYS]; // Attached displays, all on the same bus
+    __UINT8_TYPE__ count; // Number of attached displays
+    __UINT8_TYPE__ next; // Display checked first by the next dispatch (round-robin)
+    LCD1602_I2C_t* volatile active; // Display whose transfer is on the bus, 0 when the bus is free
+    volatile __UINT8_TYPE__ dispatching; // Set while a dispatch runs, completions that come meanwhile only set redispatch
+    volatile __UINT8_TYPE__ redispatch; // Set when the running dispatch has to look at the displays again
+};
 
 // Global variables
 
 
 // Global functions declaration
 /**
- * @brief Initialize the LCD1602, 2 lines, 5x8 dots, 4-bit mode
+ * @brief Initialize the LCD1602, 2 lines, 5x8 dots, 4-bit mode, backlight on
  * @name LCD1602_I2C_Init
- * @param hi2c: Pointer to the I2C handle
+ * @param lcd: Pointer to the display context, every field is reset
+ * @param transport: Pointer to the bus backend (e.g. &LCD1602_I2C_Transport_STM32)
+ * @param bus: The bus handle passed to the transport (e.g. &hi2c1)
+ * @param address: The PCF8574 address in the 8-bit form (e.g. PCF8574_ADDRESS)
+ * @param busKhz: The SCL frequency of the bus in kHz, 0 for LCD1602_I2C_BUS_KHZ. A faster bus than the driver assumes makes instructions reach the LCD1602 too early.
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_Init(LCD1602_I2C_t* lcd, const LCD1602_I2C_Transport_t* transport, void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ busKhz);
+
+/**
+ * @brief Initialize the LCD1602 behind the given I/O expander, otherwise the same as LCD1602_I2C_Init. Every other function works the same with both expanders. A PCF8575 carries the whole data bus, so the HD44780U runs in 8-bit mode: half the port writes per instruction/data, one read transaction per busy flag/DDRAM read instead of two. Each PCF8575 port write is 2 bytes, so the bytes on the wire per instruction/data stay at 4.
+ * @name LCD1602_I2C_InitExpander
+ * @param lcd: Pointer to the display context, every field is reset
+ * @param transport: Pointer to the bus backend (e.g. &LCD1602_I2C_Transport_STM32)
+ * @param bus: The bus handle passed to the transport (e.g. &hi2c1)
+ * @param address: The expander address in the 8-bit form (0x40 to 0x4E for both parts)
+ * @param busKhz: The SCL frequency of the bus in kHz, 0 for LCD1602_I2C_BUS_KHZ
+ * @param expander: LCD1602_I2C_PCF8574 (wiring of PIN_RS...) or LCD1602_I2C_PCF8575 (wiring of PCF8575_PIN_RS...)
  * @return Return the function status
  */
-extern LCD1602_I2C_Status_t LCD1602_I2C_Init(I2C_HandleTypeDef* hi2c);
+extern LCD1602_I2C_Status_t LCD1602_I2C_InitExpander(LCD1602_I2C_t* lcd, const LCD1602_I2C_Transport_t* transport, void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ busKhz, LCD1602_I2C_Expander_t expander);
+
+/**
+ * @brief Take over an LCD1602 that kept its supply through an MCU reset, without the power-on wait and without clearing it. The context must survive the reset (LCD1602_I2C_NOINIT) and have been initialized before: the address counter is read back and must follow a set DDRAM address, then display control, entry mode and the cursor are restored and the shadow framebuffer is flushed (every cell if the reset came in the middle of a transfer). A controller out of sync is resynchronized as by LCD1602_I2C_Recover, a context not initialized (power-on) gets LCD1602_I2C_InitExpander. Settings (budget, busy polling, frame rate), glyph tables, regions, marquees, asynchronous queue and scheduler are reset as by LCD1602_I2C_Init, register them again.
+ * @name LCD1602_I2C_WarmStart
+ * @param lcd: Pointer to the display context kept through the reset
+ * @param transport: Pointer to the bus backend (e.g. &LCD1602_I2C_Transport_STM32)
+ * @param bus: The bus handle passed to the transport (e.g. &hi2c1)
+ * @param address: The expander address in the 8-bit form, a context of another address is initialized
+ * @param busKhz: The SCL frequency of the bus in kHz, 0 for LCD1602_I2C_BUS_KHZ
+ * @param expander: LCD1602_I2C_PCF8574 or LCD1602_I2C_PCF8575, a context of another expander is initialized
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_WarmStart(LCD1602_I2C_t* lcd, const LCD1602_I2C_Transport_t* transport, void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ busKhz, LCD1602_I2C_Expander_t expander);
 
 /**
  * @brief Clear the LCD1602 display
  * @name LCD1602_I2C_Clear
+ * @param lcd: Pointer to the display context
  * @return Return the function status
  */
-extern LCD1602_I2C_Status_t LCD1602_I2C_Clear(void);
+extern LCD1602_I2C_Status_t LCD1602_I2C_Clear(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Set the geometry of the module, after LCD1602_I2C_Init (LCD1602_I2C_16X2 by default) and before drawing or attaching regions. The geometry is kept by LCD1602_I2C_WarmStart. Marquees are stopped on 4 rows displays.
+ * Nothing is sent unless the number of DDRAM lines changes (to or from LCD1602_I2C_16X1): then Function set and Clear display are sent, the shadow framebuffer is redrawn by the next LCD1602_I2C_Flush.
+ * @name LCD1602_I2C_SetGeometry
+ * @param lcd: Pointer to the display context
+ * @param geometry: One of LCD1602_I2C_Geometry_t
+ * @return Return the function status, LCD1602_I2C_ERROR if the geometry is unknown, LCD1602_I2C_BUSY if the Function set would have to wait for asynchronous transfers
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_SetGeometry(LCD1602_I2C_t* lcd, LCD1602_I2C_Geometry_t geometry);
 
 /**
- * @brief Move the cursor to specified position
+ * @brief Move the cursor to specified position, nothing is sent when the address counter is already there
  * @name LCD1602_I2C_MoveCursor
- * @param x: The column position (0-indexed, typically 0 to 39)
- * @param y: The row position (0-indexed, typically 0 or 1)
+ * @param lcd: Pointer to the display context
+ * @param x: The column position (0-indexed, 0 to 39, 0 to columns - 1 on 4 rows displays)
+ * @param y: The row position (0-indexed, below the number of rows)
  * @return Return the function status
  */
-extern LCD1602_I2C_Status_t LCD1602_I2C_MoveCursor(int x, int y);
+extern LCD1602_I2C_Status_t LCD1602_I2C_MoveCursor(LCD1602_I2C_t* lcd, int x, int y);
 
 /**
  * @brief Show a character on the LCD1602
  * @name LCD1602_I2C_ShowChar
+ * @param lcd: Pointer to the display context
  * @param c: The character to show
  * @return Return the function status
  */
-extern LCD1602_I2C_Status_t LCD1602_I2C_ShowChar(char c);
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowChar(LCD1602_I2C_t* lcd, char c);
 
 /**
  * @brief Show a string on the LCD1602
  * @name LCD1602_I2C_ShowString
+ * @param lcd: Pointer to the display context
  * @param str: Pointer to the null-terminated string to show
  * @return Return the function status
  */
-extern LCD1602_I2C_Status_t LCD1602_I2C_ShowString(char* str);
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowString(LCD1602_I2C_t* lcd, char* str);
+
+/**
+ * @brief Show a string from a position, wrapped at the last visible column to the start of the next row and cut after the last row. The characters are sent in DDRAM order instead of reading order: on a 4 rows display rows 0 and 2 (and 1 and 3) are contiguous, so a full screen takes one address set instead of four. The cursor ends after the last character.
+ * @name LCD1602_I2C_ShowWrapped
+ * @param lcd: Pointer to the display context
+ * @param x: The column position (0-indexed, below the number of columns)
+ * @param y: The row position (0-indexed, below the number of rows)
+ * @param str: Pointer to the null-terminated string to show
+ * @return Return the function status, LCD1602_I2C_ERROR if the position is invalid
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowWrapped(LCD1602_I2C_t* lcd, int x, int y, const char* str);
+
+/**
+ * @brief Show formatted text at the cursor without libc printf or heap: characters are encoded into the burst buffer while they are formatted, so the text goes out in as few transactions as ShowString
+ * - Conversions: %d %i %u %x %X %c %s %% (with an l length for long arguments, values are shown on 32 bits)
+ * - Flags and width: %5d pads with spaces on the left, %-5d on the right, %05d with zeros after the sign, so a value rewritten in place never leaves stale characters
+ * - Fixed point: a precision on %d/%u is a number of decimals (9 at most), %7.2d of -1234 shows " -12.34". On %x/%X it is the minimum number of digits, on %s the maximum number of characters.
+ * - Width and precision saturate at 40, the length of a DDRAM line, %s prints at most 40 characters
+ * @name LCD1602_I2C_Printf
+ * @param lcd: Pointer to the display context
+ * @param fmt: Pointer to the null-terminated format string
+ * @return Return the function status, LCD1602_I2C_ERROR on an unknown conversion (the text before it is shown)
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_Printf(LCD1602_I2C_t* lcd, const char* fmt, ...);
 
 /**
  * @brief Shift the entire display left or right
  * @name LCD1602_I2C_ShiftDisplay
+ * @param lcd: Pointer to the display context
  * @param right: Set to 1 to shift right, 0 to shift left
  * @return Return the function status
  */
-extern LCD1602_I2C_Status_t LCD1602_I2C_ShiftDisplay(int right);
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShiftDisplay(LCD1602_I2C_t* lcd, int right);
+
+/**
+ * @brief Write a string into the shadow framebuffer, nothing is sent to the LCD1602 until LCD1602_I2C_Flush is called
+ * @name LCD1602_I2C_ShadowWrite
+ * @param lcd: Pointer to the display context
+ * @param x: The column position (0-indexed, 0 to 39, 0 to columns - 1 on 4 rows displays), characters past the end of the row are dropped
+ * @param y: The row position (0-indexed, below the number of rows)
+ * @param str: Pointer to the null-terminated string to write
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShadowWrite(LCD1602_I2C_t* lcd, int x, int y, char* str);
+
+/**
+ * @brief Write formatted text into the shadow framebuffer, same conversions as LCD1602_I2C_Printf. Nothing is sent to the LCD1602 until LCD1602_I2C_Flush is called.
+ * @name LCD1602_I2C_ShadowPrintf
+ * @param lcd: Pointer to the display context
+ * @param x: The column position (0-indexed, 0 to 39, 0 to columns - 1 on 4 rows displays), characters past the end of the row are dropped
+ * @param y: The row position (0-indexed, below the number of rows)
+ * @param fmt: Pointer to the null-terminated format string
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShadowPrintf(LCD1602_I2C_t* lcd, int x, int y, const char* fmt, ...);
+
+/**
+ * @brief Fill the shadow framebuffer with spaces, nothing is sent to the LCD1602 until LCD1602_I2C_Flush is called
+ * @name LCD1602_I2C_ShadowClear
+ * @param lcd: Pointer to the display context
+ */
+extern void LCD1602_I2C_ShadowClear(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Send the cells of the shadow framebuffer that differ from the LCD1602 DDRAM, grouped into contiguous runs with a single DDRAM address set each. Cells are mapped through the current display shift. The cursor is put back where it was before the flush.
+ * @name LCD1602_I2C_Flush
+ * @param lcd: Pointer to the display context
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_Flush(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Set the entry mode, how the cursor moves and whether the display shifts after each character. The driver follows both on every write.
+ * @name LCD1602_I2C_SetEntryMode
+ * @param lcd: Pointer to the display context
+ * @param increment: Set to 1 to move the cursor right after a write (default), 0 to move it left
+ * @param shift: Set to 1 to shift the display with every write so the cursor stays in place, 0 to keep the display still (default)
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_SetEntryMode(LCD1602_I2C_t* lcd, int increment, int shift);
+
+/**
+ * @brief Register the glyph table drawn by LCD1602_I2C_ShowGlyph and LCD1602_I2C_ShadowGlyph. Every CGRAM character is considered free again, register the table again after changing a bitmap.
+ * @name LCD1602_I2C_SetGlyphs
+ * @param lcd: Pointer to the display context
+ * @param glyphs: Pointer to the glyph table, kept by the driver (e.g. a const array in flash)
+ * @param count: Number of glyphs, the glyph ids are 0 to count - 1 (at most LCD1602_I2C_GLYPH_UTF8, the ids above name the UTF-8 glyphs)
+ */
+extern void LCD1602_I2C_SetGlyphs(LCD1602_I2C_t* lcd, const LCD1602_I2C_Glyph_t* glyphs, __UINT16_TYPE__ count);
+
+/**
+ * @brief Show a registered glyph at the cursor. The 8 CGRAM characters are used as a least recently used cache: the glyph is uploaded (9 instructions) only when no CGRAM character holds it, then the cursor is put back. Only 8 different glyphs can be on the display at the same time, uploading a 9th one changes the cells showing the evicted glyph.
+ * @name LCD1602_I2C_ShowGlyph
+ * @param lcd: Pointer to the display context
+ * @param id: The glyph id
+ * @return Return the function status, LCD1602_I2C_ERROR if the id is not registered or the cursor position is unknown (after a failed transfer) when an upload is needed
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowGlyph(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id);
+
+/**
+ * @brief Draw a registered glyph into the shadow framebuffer, nothing is sent to the LCD1602 until LCD1602_I2C_Flush is called. The flush uploads the glyphs of the frame that are not in CGRAM, keeping the ones the frame still shows, so the cost of a frame grows with the number of new glyphs only.
+ * @name LCD1602_I2C_ShadowGlyph
+ * @param lcd: Pointer to the display context
+ * @param x: The column position (0-indexed, 0 to 39, 0 to columns - 1 on 4 rows displays)
+ * @param y: The row position (0-indexed, below the number of rows)
+ * @param id: The glyph id
+ * @return Return the function status, LCD1602_I2C_ERROR if the position or the id is invalid
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShadowGlyph(LCD1602_I2C_t* lcd, int x, int y, __UINT16_TYPE__ id);
+
+/**
+ * @brief Get the glyph cache counters, counted per glyph drawn (each LCD1602_I2C_ShowGlyph call and each glyph cell of a flush)
+ * @name LCD1602_I2C_GlyphStats
+ * @param lcd: Pointer to the display context
+ * @param hits: Pointer to store the draws served from CGRAM, may be 0
+ * @param misses: Pointer to store the draws that needed an upload, may be 0
+ */
+extern void LCD1602_I2C_GlyphStats(LCD1602_I2C_t* lcd, __UINT32_TYPE__* hits, __UINT32_TYPE__* misses);
+
+/**
+ * @brief Select the character ROM of the HD44780U, used to map UTF-8 text to character codes (LCD1602_I2C_ROM_A00 after LCD1602_I2C_Init). Text already on the display is not changed.
+ * @name LCD1602_I2C_SetRom
+ * @param lcd: Pointer to the display context
+ * @param rom: LCD1602_I2C_ROM_A00 or LCD1602_I2C_ROM_A02
+ */
+extern void LCD1602_I2C_SetRom(LCD1602_I2C_t* lcd, LCD1602_I2C_Rom_t rom);
+
+/**
+ * @brief Register the glyphs drawn for the characters of UTF-8 text that the character ROM does not have. A built-in table (backslash and tilde for the A00 ROM, a few accented capitals and letters, euro sign, arrows) is registered by LCD1602_I2C_Init. Every CGRAM character holding a UTF-8 glyph is considered free again.
+ * @name LCD1602_I2C_SetUtf8Glyphs
+ * @param lcd: Pointer to the display context
+ * @param glyphs: Pointer to the table sorted by codepoint, kept by the driver (e.g. a const array in flash), 0 for the built-in table
+ * @param count: Number of entries, at most 0x7FFF
+ */
+extern void LCD1602_I2C_SetUtf8Glyphs(LCD1602_I2C_t* lcd, const LCD1602_I2C_Utf8Glyph_t* glyphs, __UINT16_TYPE__ count);
+
+/**
+ * @brief Show UTF-8 text at the cursor. Each character is shown with its character ROM code, or its glyph of the UTF-8 glyph table (as by LCD1602_I2C_ShowGlyph), or LCD1602_I2C_UTF8_REPLACEMENT. Full-width katakana take 2 cells (A00 ROM) when voiced. A character split between two calls is shown by the second one.
+ * @name LCD1602_I2C_ShowUtf8
+ * @param lcd: Pointer to the display context
+ * @param str: Pointer to the null-terminated UTF-8 text
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowUtf8(LCD1602_I2C_t* lcd, const char* str);
+
+/**
+ * @brief Write UTF-8 text into the shadow framebuffer, nothing is sent to the LCD1602 until LCD1602_I2C_Flush is called. Characters are mapped as by LCD1602_I2C_ShowUtf8, the glyph cells are loaded into CGRAM by the flush. Characters beyond the last column are dropped.
+ * @name LCD1602_I2C_ShadowUtf8
+ * @param lcd: Pointer to the display context
+ * @param x: The column position (0-indexed, 0 to 39, 0 to columns - 1 on 4 rows displays)
+ * @param y: The row position (0-indexed, below the number of rows)
+ * @param str: Pointer to the null-terminated UTF-8 text
+ * @return Return the function status, LCD1602_I2C_ERROR if the position is invalid
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShadowUtf8(LCD1602_I2C_t* lcd, int x, int y, const char* str);
+
+/**
+ * @brief Start a marquee on a row: the text is preloaded into the 40 DDRAM columns of the row, starting at the first display column, and scrolled by LCD1602_I2C_MarqueeStep. Text up to 40 characters is padded with spaces to 40 and loops without any further DDRAM write.
+ * - The display shift of the HD44780U moves both rows, a row that is not a marquee moves too (its shadow framebuffer content is redrawn by each LCD1602_I2C_Flush, which costs up to 16 writes per step)
+ * - LCD1602_I2C_Flush does not write a marquee row, LCD1602_I2C_Clear stops the marquees
+ * - Not available on 4 rows displays, where a DDRAM line holds 2 rows
+ * @name LCD1602_I2C_MarqueeStart
+ * @param lcd: Pointer to the display context
+ * @param y: The row position (0-indexed, below the number of rows)
+ * @param text: Pointer to the null-terminated text, kept by the driver until the marquee stops
+ * @return Return the function status, LCD1602_I2C_ERROR if the row is invalid or the text is empty
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_MarqueeStart(LCD1602_I2C_t* lcd, int y, const char* text);
+
+/**
+ * @brief Scroll the marquees by one character to the left with a single display shift instruction. Text longer than 40 characters also needs the column that just left the display on the left refilled with the character that shows up 24 steps later: one address set and one data write per row, plus one address set to put the cursor back.
+ * @name LCD1602_I2C_MarqueeStep
+ * @param lcd: Pointer to the display context
+ * @return Return the function status, LCD1602_I2C_ERROR if no marquee is running
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_MarqueeStep(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Stop the marquee of a row, the text stays on the display and the row is written by LCD1602_I2C_Flush again
+ * @name LCD1602_I2C_MarqueeStop
+ * @param lcd: Pointer to the display context
+ * @param y: The row position (0-indexed, 0 or 1)
+ */
+extern void LCD1602_I2C_MarqueeStop(LCD1602_I2C_t* lcd, int y);
+
+/**
+ * @brief Turn the backlight on or off, the new state is sent right away and kept for every following transfer
+ * @name LCD1602_I2C_SetBacklight
+ * @param lcd: Pointer to the display context
+ * @param on: Set to 1 to turn on the backlight, 0 to turn off
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_SetBacklight(LCD1602_I2C_t* lcd, int on);
+
+/**
+ * @brief Choose how the driver waits for long instructions (Clear display, Return home). With busy flag polling, the next access that comes too early reads the busy flag until the LCD1602 is ready instead of sleeping for the datasheet execution time. Asynchronous calls always use the worst-case time.
+ * @name LCD1602_I2C_SetBusyPolling
+ * @param lcd: Pointer to the display context
+ * @param enable: Set to 1 to poll the busy flag, 0 to use fixed delays (default)
+ */
+extern void LCD1602_I2C_SetBusyPolling(LCD1602_I2C_t* lcd, int enable);
+
+/**
+ * @brief Bound the time of every blocking call. A transfer or wait that would end after the budget of the call is not started and the call returns LCD1602_I2C_DEADLINE (the instruction still executing is waited for by a later call), the transport timeouts are cut to what is left of the budget. The worst case is the budget plus the timeout granularity of the transport (up to 2 ticks with HAL_GetTick, 10ms on Linux). The budget has to cover the largest transaction of the calls made (a full burst), see LCD1602_I2C_BURST_FRAMES.
+ * @name LCD1602_I2C_SetBudget
+ * @param lcd: Pointer to the display context, after LCD1602_I2C_Init
+ * @param budgetUs: The budget of one call in us, 0 for no limit (default)
+ */
+extern void LCD1602_I2C_SetBudget(LCD1602_I2C_t* lcd, __UINT32_TYPE__ budgetUs);
+
+/**
+ * @brief Recover the bus and resynchronize the LCD1602: transport recover hook (9 SCL clocks + STOP), probe, then the 8-bit/4-bit reset sequence, function set, display control, entry mode and return home. Runs on its own after a NACK, bus error or timeout (the failing call still reports it), and resumes at the next call when it ran out of budget. Call it after an asynchronous error, or to force it. DDRAM, CGRAM and the display shift are forgotten, marquees are stopped, the next LCD1602_I2C_Flush redraws the shadow.
+ * @name LCD1602_I2C_Recover
+ * @param lcd: Pointer to the display context
+ * @return Return the function status, LCD1602_I2C_BUSY while the asynchronous queue is not empty
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_Recover(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Read back the next cells of DDRAM and rewrite the ones that do not hold what the driver last wrote (corrupted by noise on the bus or the supply). Call it when the display is idle, a few cells at a time: the 80 cells are walked in turn, one set DDRAM address per call, one read per cell (5 transactions and about 1.7ms at 100kHz, 3 transactions behind a PCF8575) plus one set DDRAM address and one write per corrupted cell. The cursor and the entry mode are put back. Does nothing while DDRAM is unknown (after a bus recovery), the next LCD1602_I2C_Flush redraws it.
+ * @name LCD1602_I2C_Scrub
+ * @param lcd: Pointer to the display context
+ * @param cells: Number of cells to check, 1 to 80
+ * @return Return the function status, LCD1602_I2C_BUSY while the asynchronous queue is not empty
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_Scrub(LCD1602_I2C_t* lcd, __UINT8_TYPE__ cells);
+
+/**
+ * @brief Get the DDRAM scrubbing counters
+ * @name LCD1602_I2C_ScrubStats
+ * @param lcd: Pointer to the display context
+ * @param checked: Pointer to store the number of cells read back, can be 0
+ * @param corrupted: Pointer to store the number of cells found corrupted and rewritten, can be 0
+ */
+extern void LCD1602_I2C_ScrubStats(LCD1602_I2C_t* lcd, __UINT32_TYPE__* checked, __UINT32_TYPE__* corrupted);
+
+/**
+ * @brief Attach a region to a display, before any post. The region is reset to an empty text, the shadow framebuffer under it is left as is until the first post.
+ * @name LCD1602_I2C_RegionAttach
+ * @param lcd: Pointer to the display context, after LCD1602_I2C_Init
+ * @param region: Pointer to the region, static storage owned by the application
+ * @param x: The first column (0-indexed, 0 to 39, 0 to columns - 1 on 4 rows displays)
+ * @param y: The row position (0-indexed, below the number of rows)
+ * @param width: Number of columns, 1 to LCD1602_I2C_REGION_CHARS, the region must end with the row (column 40, or the last column on 4 rows displays)
+ * @return Return the function status, LCD1602_I2C_ERROR if the position is invalid or LCD1602_I2C_REGIONS regions are attached already
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_RegionAttach(LCD1602_I2C_t* lcd, LCD1602_I2C_Region_t* region, int x, int y, int width);
+
+/**
+ * @brief Post the text of a region, callable from a task or an interrupt. Nothing is sent, the next LCD1602_I2C_Refresh copies the latest text into the shadow framebuffer.
+ * @name LCD1602_I2C_RegionPost
+ * @param region: Pointer to an attached region, posted to by this producer only
+ * @param str: Pointer to the null-terminated string, cut to the region width or padded with spaces
+ */
+extern void LCD1602_I2C_RegionPost(LCD1602_I2C_Region_t* region, const char* str);
+
+/**
+ * @brief Post formatted text to a region, same conversions as LCD1602_I2C_Printf. The text is cut to the region width or padded with spaces.
+ * @name LCD1602_I2C_RegionPrintf
+ * @param region: Pointer to an attached region, posted to by this producer only
+ * @param fmt: Pointer to the null-terminated format string
+ * @return Return the function status, the text formatted up to an unknown conversion is posted anyway
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_RegionPrintf(LCD1602_I2C_Region_t* region, const char* fmt, ...);
+
+/**
+ * @brief Limit how often LCD1602_I2C_Refresh sends something. Posts made in between stay in the regions and collapse into one flush.
+ * @name LCD1602_I2C_SetFrameRate
+ * @param lcd: Pointer to the display context, after LCD1602_I2C_Init
+ * @param fps: Refreshes per second at most, 0 for no limit (default)
+ */
+extern void LCD1602_I2C_SetFrameRate(LCD1602_I2C_t* lcd, __UINT16_TYPE__ fps);
+
+/**
+ * @brief Copy the regions posted since the last refresh into the shadow framebuffer and send the changed cells with one LCD1602_I2C_Flush. Call it periodically from the task owning the display, it returns right away when the frame period has not elapsed or nothing changed. A flush that fails (or runs out of budget) is tried again by the next refresh, after a bus recovery the whole shadow framebuffer is redrawn. LCD1602_I2C_RefreshAsync returns LCD1602_I2C_ERROR until LCD1602_I2C_Recover ran after an asynchronous error.
+ * @name LCD1602_I2C_Refresh
+ * @param lcd: Pointer to the display context
+ * @return Return the status of the flush, LCD1602_I2C_OK when nothing was due
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_Refresh(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Asynchronous variants of the functions above. The instructions/datas are encoded into the transmit queue and sent by the transport writeAsync function (interrupt/DMA), the call returns immediately. Transports without writeAsync send them right away. Execution times are enforced by the drain instead of sleeping. A call is queued entirely or not at all.
+ * @name LCD1602_I2C_ClearAsync, LCD1602_I2C_MoveCursorAsync, LCD1602_I2C_ShowCharAsync, LCD1602_I2C_ShowStringAsync, LCD1602_I2C_ShiftDisplayAsync, LCD1602_I2C_FlushAsync, LCD1602_I2C_ShowGlyphAsync, LCD1602_I2C_PrintfAsync, LCD1602_I2C_MarqueeStepAsync, LCD1602_I2C_RefreshAsync
+ * @param lcd: Pointer to the display context
+ * @return Return the function status, LCD1602_I2C_BUSY if the queue does not have enough free entries
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_ClearAsync(LCD1602_I2C_t* lcd);
+extern LCD1602_I2C_Status_t LCD1602_I2C_MoveCursorAsync(LCD1602_I2C_t* lcd, int x, int y);
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowCharAsync(LCD1602_I2C_t* lcd, char c);
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowStringAsync(LCD1602_I2C_t* lcd, char* str);
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShiftDisplayAsync(LCD1602_I2C_t* lcd, int right);
+extern LCD1602_I2C_Status_t LCD1602_I2C_FlushAsync(LCD1602_I2C_t* lcd);
+extern LCD1602_I2C_Status_t LCD1602_I2C_ShowGlyphAsync(LCD1602_I2C_t* lcd, __UINT16_TYPE__ id);
+extern LCD1602_I2C_Status_t LCD1602_I2C_PrintfAsync(LCD1602_I2C_t* lcd, const char* fmt, ...);
+extern LCD1602_I2C_Status_t LCD1602_I2C_MarqueeStepAsync(LCD1602_I2C_t* lcd);
+extern LCD1602_I2C_Status_t LCD1602_I2C_RefreshAsync(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Set the function called when an asynchronous call completes
+ * @name LCD1602_I2C_SetAsyncCallback
+ * @param lcd: Pointer to the display context
+ * @param callback: The completion callback, 0 to disable it
+ */
+extern void LCD1602_I2C_SetAsyncCallback(LCD1602_I2C_t* lcd, LCD1602_I2C_AsyncCallback_t callback);
+
+/**
+ * @brief Get the number of queued transfers that are not completed yet
+ * @name LCD1602_I2C_AsyncQueueDepth
+ * @param lcd: Pointer to the display context
+ * @return Return the number of pending entries
+ */
+extern __UINT8_TYPE__ LCD1602_I2C_AsyncQueueDepth(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Notify the driver that the current asynchronous transfer is sent, call it from the transport completion interrupt (HAL_I2C_MasterTxCpltCallback on STM32) with the display of that bus
+ * @name LCD1602_I2C_AsyncTxComplete
+ * @param lcd: Pointer to the display context
+ */
+extern void LCD1602_I2C_AsyncTxComplete(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Notify the driver that the current asynchronous transfer failed, call it from the transport error interrupt (HAL_I2C_ErrorCallback on STM32). The rest of the failing call is dropped.
+ * @name LCD1602_I2C_AsyncTxError
+ * @param lcd: Pointer to the display context
+ */
+extern void LCD1602_I2C_AsyncTxError(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Advance the drain once an execution time has elapsed, call it periodically (e.g. from the main loop or a timer interrupt)
+ * @name LCD1602_I2C_AsyncPoll
+ * @param lcd: Pointer to the display context
+ */
+extern void LCD1602_I2C_AsyncPoll(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Initialize a bus scheduler without any display
+ * @name LCD1602_I2C_SchedInit
+ * @param sched: Pointer to the scheduler
+ */
+extern void LCD1602_I2C_SchedInit(LCD1602_I2C_Sched_t* sched);
+
+/**
+ * @brief Hand the transfers of an initialized display over to a bus scheduler
+ * @name LCD1602_I2C_SchedAttach
+ * @param sched: Pointer to the scheduler
+ * @param lcd: Pointer to the display context, on the same bus handle as the displays already attached
+ * @return Return the function status, LCD1602_I2C_ERROR if the scheduler is full, the bus differs or the display is attached already
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_SchedAttach(LCD1602_I2C_Sched_t* sched, LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Notify the scheduler that the transfer on the bus is sent, call it from the transport completion interrupt instead of LCD1602_I2C_AsyncTxComplete
+ * @name LCD1602_I2C_SchedTxComplete
+ * @param sched: Pointer to the scheduler of the interrupting bus
+ */
+extern void LCD1602_I2C_SchedTxComplete(LCD1602_I2C_Sched_t* sched);
+
+/**
+ * @brief Notify the scheduler that the transfer on the bus failed, call it from the transport error interrupt instead of LCD1602_I2C_AsyncTxError
+ * @name LCD1602_I2C_SchedTxError
+ * @param sched: Pointer to the scheduler of the interrupting bus
+ */
+extern void LCD1602_I2C_SchedTxError(LCD1602_I2C_Sched_t* sched);
+
+/**
+ * @brief Release the displays whose execution time has elapsed and start the next transfer, call it periodically instead of LCD1602_I2C_AsyncPoll
+ * @name LCD1602_I2C_SchedPoll
+ * @param sched: Pointer to the scheduler
+ * @return Return the time in us until the next display deadline, 0 if the bus is in use or no display is waiting
+ */
+extern __UINT32_TYPE__ LCD1602_I2C_SchedPoll(LCD1602_I2C_Sched_t* sched);
+
+/**
+ * @brief Get the number of queued transfers of all attached displays that are not completed yet
+ * @name LCD1602_I2C_SchedQueueDepth
+ * @param sched: Pointer to the scheduler
+ * @return Return the number of pending entries
+ */
+extern __UINT16_TYPE__ LCD1602_I2C_SchedQueueDepth(LCD1602_I2C_Sched_t* sched);
+
+#if LCD1602_I2C_TRACE
+/**
+ * @brief Get the instrumentation counters (LCD1602_I2C_TRACE builds only). Read from another thread, a counter being updated may be one call behind the others.
+ * @name LCD1602_I2C_TraceStats
+ * @param lcd: Pointer to the display context
+ * @param stats: Pointer to store a copy of the counters
+ */
+extern void LCD1602_I2C_TraceStats(LCD1602_I2C_t* lcd, LCD1602_I2C_TraceStats_t* stats);
+
+/**
+ * @brief Reset the instrumentation counters, the trace ring is kept
+ * @name LCD1602_I2C_TraceReset
+ * @param lcd: Pointer to the display context
+ */
+extern void LCD1602_I2C_TraceReset(LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Copy the bytes logged in the trace ring since a cursor, oldest first (LCD1602_I2C_TRACE builds only). Lock-free: it never blocks the driver, callable from a low priority task dumping the trace to a debug UART while the display is in use. Bytes overwritten before they were copied are skipped, the cursor then jumps by more than the count returned.
+ * @name LCD1602_I2C_TraceRead
+ * @param lcd: Pointer to the display context
+ * @param cursor: Pointer to the sequence number of the next byte to read, 0 for the oldest one kept, advanced past the bytes copied
+ * @param entries: Pointer to store the entries
+ * @param max: Number of entries the array can hold
+ * @return Return the number of entries copied, 0 once the reader caught up with the driver
+ */
+extern __UINT16_TYPE__ LCD1602_I2C_TraceRead(LCD1602_I2C_t* lcd, __UINT32_TYPE__* cursor, LCD1602_I2C_TraceEntry_t* entries, __UINT16_TYPE__ max);
+#endif
 
 // Test functions declaration
-extern void test_lcd_i2c_display_shift(void);
-extern void test_lcd_i2c_cursor_shift(void);
+extern void test_lcd_i2c_display_shift(LCD1602_I2C_t* lcd);
+extern void test_lcd_i2c_cursor_shift(LCD1602_I2C_t* lcd);
 
 #endif // LCD_I2C_H
\ No newline at end of file
@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime, clock_nanosleep and CLOCK_MONOTONIC under -std=c11
+#include "lcd_i2c_linux.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+// Local functions declaration
+
+/**
+ * @brief Run one I2C_RDWR ioctl, the messages are sent with a repeated START between them and one STOP at the end.
+ * @name LCD1602_I2C_Linux_Rdwr
+ * @param bus: Pointer to the LCD1602_I2C_LinuxBus_t
+ * @param msgs: Pointer to the messages, 7-bit addresses
+ * @param count: Number of messages
+ * @param timeoutUs: Timeout of the transfer, set on the adapter (10ms steps) when it changes
+ * @return Return the function status, LCD1602_I2C_NACK/_TIMEOUT/_BUS_ERROR from the errno of the adapter driver
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Linux_Rdwr(void* bus, struct i2c_msg* msgs, __UINT8_TYPE__ count, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Run one I2C_RDWR ioctl with a single message. The 8-bit address is converted to the 7-bit form used by Linux.
+ * @name LCD1602_I2C_Linux_Transfer
+ * @param bus: Pointer to the LCD1602_I2C_LinuxBus_t
+ * @param address: The device address (8-bit form)
+ * @param flags: 0 to write, I2C_M_RD to read
+ * @param data: Pointer to the bytes to send/receive
+ * @param length: Number of bytes, 0 for a quick write (probe)
+ * @param timeoutUs: Timeout of the transfer
+ * @return Return the function status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Linux_Transfer(void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ flags, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport write, one I2C_RDWR write message
+ * @name LCD1602_I2C_Linux_Write
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Linux_Write(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport read, one I2C_RDWR read message
+ * @name LCD1602_I2C_Linux_Read
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Linux_Read(void* bus, __UINT8_TYPE__ address, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport probe, zero length write (address only), or a 1-byte read of the port on adapters that do not support zero length messages (like i2cdetect)
+ * @name LCD1602_I2C_Linux_Probe
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Linux_Probe(void* bus, __UINT8_TYPE__ address, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport transfer, the messages of a busy flag/data read in one I2C_RDWR ioctl (no system call and no bus idle time between the Enable pulse and the read)
+ * @name LCD1602_I2C_Linux_Segments
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Linux_Segments(void* bus, __UINT8_TYPE__ address, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport delay, clock_nanosleep on CLOCK_MONOTONIC
+ * @name LCD1602_I2C_Linux_DelayUs
+ */
+static void LCD1602_I2C_Linux_DelayUs(void* bus, __UINT32_TYPE__ us);
+
+/**
+ * @brief Transport timestamp, clock_gettime on CLOCK_MONOTONIC
+ * @name LCD1602_I2C_Linux_Micros
+ */
+static __UINT32_TYPE__ LCD1602_I2C_Linux_Micros(void* bus);
+
+
+// Global variables
+const LCD1602_I2C_Transport_t LCD1602_I2C_Transport_Linux = {
+    .write = LCD1602_I2C_Linux_Write,
+    .read = LCD1602_I2C_Linux_Read,
+    .probe = LCD1602_I2C_Linux_Probe,
+    .delayUs = LCD1602_I2C_Linux_DelayUs,
+    .micros = LCD1602_I2C_Linux_Micros,
+    .writeAsync = 0, // i2c-dev is blocking, asynchronous calls are sent right away
+    .recover = 0, // Adapter drivers with bus recovery (i2c_recovery_info) clock a stuck slave free on their own
+    .transfer = LCD1602_I2C_Linux_Segments,
+    .timeResolutionUs = 1,
+};
+
+
+// Local functions definition
+
+LCD1602_I2C_Status_t LCD1602_I2C_Linux_Rdwr(void* bus, struct i2c_msg* msgs, __UINT8_TYPE__ count, __UINT32_TYPE__ timeoutUs){
+    LCD1602_I2C_LinuxBus_t* linuxBus = (LCD1602_I2C_LinuxBus_t*)bus;
+    unsigned long timeout = (timeoutUs + 9999) / 10000; // I2C_TIMEOUT is in units of 10ms
+    struct i2c_rdwr_ioctl_data transfer = {
+        .msgs = msgs,
+        .nmsgs = count,
+    };
+
+    if(timeout != linuxBus->timeout && ioctl(linuxBus->fd, I2C_TIMEOUT, timeout) == 0){
+        linuxBus->timeout = timeout;
+    }
+    if(ioctl(linuxBus->fd, I2C_RDWR, &transfer) < 0){
+        if(errno == ENXIO || errno == EREMOTEIO) return LCD1602_I2C_NACK;
+        if(errno == ETIMEDOUT) return LCD1602_I2C_TIMEOUT;
+        if(errno == EAGAIN || errno == EIO || errno == EBUSY) return LCD1602_I2C_BUS_ERROR; // Arbitration lost, bus error or bus held
+        return LCD1602_I2C_ERROR;
+    }
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Linux_Transfer(void* bus, __UINT8_TYPE__ address, __UINT16_TYPE__ flags, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs){
+    struct i2c_msg msg = {
+        .addr = address >> 1, // Linux uses the 7-bit address
+        .flags = flags,
+        .len = length,
+        .buf = data,
+    };
+    return LCD1602_I2C_Linux_Rdwr(bus, &msg, 1, timeoutUs);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Linux_Write(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs){
+    return LCD1602_I2C_Linux_Transfer(bus, address, 0, (__UINT8_TYPE__*)data, length, timeoutUs);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Linux_Read(void* bus, __UINT8_TYPE__ address, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs){
+    return LCD1602_I2C_Linux_Transfer(bus, address, I2C_M_RD, data, length, timeoutUs);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Linux_Probe(void* bus, __UINT8_TYPE__ address, __UINT32_TYPE__ timeoutUs){
+    LCD1602_I2C_LinuxBus_t* linuxBus = (LCD1602_I2C_LinuxBus_t*)bus;
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+    __UINT8_TYPE__ port = 0;
+
+    if(!linuxBus->probeRead){
+        status = LCD1602_I2C_Linux_Transfer(bus, address, 0, 0, 0, timeoutUs);
+        if(status != LCD1602_I2C_ERROR || errno != EOPNOTSUPP) return status;
+        linuxBus->probeRead = 1; // I2C_AQ_NO_ZERO_LEN adapter, reading the port leaves the PCF8574 outputs as they are
+    }
+    return LCD1602_I2C_Linux_Transfer(bus, address, I2C_M_RD, &port, 1, timeoutUs);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Linux_Segments(void* bus, __UINT8_TYPE__ address, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count, __UINT32_TYPE__ timeoutUs){
+    struct i2c_msg msgs[8];
+
+    if(count > 8) return LCD1602_I2C_ERROR; // A read takes 5 messages at most
+    for(__UINT8_TYPE__ i = 0; i < count; i++){
+        msgs[i].addr = address >> 1;
+        msgs[i].flags = segments[i].read ? I2C_M_RD : 0;
+        msgs[i].len = segments[i].length;
+        msgs[i].buf = segments[i].data;
+    }
+    return LCD1602_I2C_Linux_Rdwr(bus, msgs, count, timeoutUs);
+}
+
+
+void LCD1602_I2C_Linux_DelayUs(void* bus, __UINT32_TYPE__ us){
+    struct timespec ts = {
+        .tv_sec = us / 1000000,
+        .tv_nsec = (long)(us % 1000000) * 1000,
+    };
+    (void)bus;
+    while(clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR); // Keep sleeping the remaining time after a signal
+}
+
+
+__UINT32_TYPE__ LCD1602_I2C_Linux_Micros(void* bus){
+    struct timespec ts;
+    (void)bus;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (__UINT32_TYPE__)((__UINT64_TYPE__)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+
+// Global functions definition
+
+LCD1602_I2C_Status_t LCD1602_I2C_Linux_Open(LCD1602_I2C_LinuxBus_t* bus, const char* path){
+    bus->fd = open(path, O_RDWR);
+    bus->timeout = 0; // Adapter default until the first transfer sets it
+    bus->probeRead = 0;
+    return (bus->fd < 0) ? LCD1602_I2C_ERROR : LCD1602_I2C_OK;
+}
+
+
+void LCD1602_I2C_Linux_Close(LCD1602_I2C_LinuxBus_t* bus){
+    if(bus->fd >= 0) close(bus->fd);
+    bus->fd = -1;
+}
@@ -0,0 +1,41 @@
+/**
+ * @author: Trong Phan Minh
+ * @date: 19/01/2026
+ * @brief: Linux i2c-dev transport for the LCD1602 driver. Open the adapter with LCD1602_I2C_Linux_Open, then pass &LCD1602_I2C_Transport_Linux and the bus to LCD1602_I2C_Init. Every transaction (a whole burst included) is a single I2C_RDWR ioctl, the write/read/write messages of a busy flag or data read go out in one ioctl with repeated STARTs.
+ */
+
+
+#ifndef LCD_I2C_LINUX_H
+#define LCD_I2C_LINUX_H
+
+// Additional library includes
+#include "lcd_i2c.h"
+
+// Typedef
+typedef struct {
+    int fd; // File descriptor of /dev/i2c-N
+    unsigned long timeout; // Adapter timeout last set with I2C_TIMEOUT (10ms units), 0 for the adapter default
+    __UINT8_TYPE__ probeRead; // Set once the adapter rejected a zero length write (I2C_AQ_NO_ZERO_LEN), probes then read 1 byte
+} LCD1602_I2C_LinuxBus_t;
+
+// Global variables
+extern const LCD1602_I2C_Transport_t LCD1602_I2C_Transport_Linux;
+
+// Global functions declaration
+/**
+ * @brief Open an i2c-dev adapter
+ * @name LCD1602_I2C_Linux_Open
+ * @param bus: Pointer to the bus to initialize
+ * @param path: Path of the adapter, e.g. "/dev/i2c-1"
+ * @return Return the function status
+ */
+extern LCD1602_I2C_Status_t LCD1602_I2C_Linux_Open(LCD1602_I2C_LinuxBus_t* bus, const char* path);
+
+/**
+ * @brief Close an i2c-dev adapter opened with LCD1602_I2C_Linux_Open
+ * @name LCD1602_I2C_Linux_Close
+ * @param bus: Pointer to the bus
+ */
+extern void LCD1602_I2C_Linux_Close(LCD1602_I2C_LinuxBus_t* bus);
+
+#endif // LCD_I2C_LINUX_H
@@ -0,0 +1,559 @@
+#include "lcd_i2c_mock.h"
+#include <string.h>
+
+// Local functions declaration
+
+/**
+ * @brief Transport write, decodes every byte through the controller model
+ * @name LCD1602_I2C_Mock_Write
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Mock_Write(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport read, returns the PCF8574 pins with the data pins driven by the controller model
+ * @name LCD1602_I2C_Mock_Read
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Mock_Read(void* bus, __UINT8_TYPE__ address, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport probe, acknowledged only for the addresses of the devices on the bus
+ * @name LCD1602_I2C_Mock_Probe
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Mock_Probe(void* bus, __UINT8_TYPE__ address, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport transfer, the messages one after the other, each counted and timed as a transaction (a repeated START costs about as much as a STOP and a START)
+ * @name LCD1602_I2C_Mock_Segments
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Mock_Segments(void* bus, __UINT8_TYPE__ address, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport recover, 9 SCL clocks and a STOP: releases a stuck bus
+ * @name LCD1602_I2C_Mock_Recover
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Mock_Recover(void* bus);
+
+/**
+ * @brief Transport delay, advances the virtual time
+ * @name LCD1602_I2C_Mock_DelayUs
+ */
+static void LCD1602_I2C_Mock_DelayUs(void* bus, __UINT32_TYPE__ us);
+
+/**
+ * @brief Transport timestamp, the virtual time in us
+ * @name LCD1602_I2C_Mock_Micros
+ */
+static __UINT32_TYPE__ LCD1602_I2C_Mock_Micros(void* bus);
+
+/**
+ * @brief Transport asynchronous write, kept pending until LCD1602_I2C_Mock_CompleteAsync
+ * @name LCD1602_I2C_Mock_WriteAsync
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Mock_WriteAsync(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length);
+
+/**
+ * @brief Account for one byte on the wire: advance the virtual time by 9 bit times and record it
+ * @name LCD1602_I2C_Mock_Byte
+ * @return Return the timestamp (us) at the end of the byte
+ */
+static __UINT32_TYPE__ LCD1602_I2C_Mock_Byte(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ type, __UINT8_TYPE__ address, __UINT8_TYPE__ data);
+
+/**
+ * @brief Account for the START and STOP conditions of a transaction
+ * @name LCD1602_I2C_Mock_Transaction
+ */
+static void LCD1602_I2C_Mock_Transaction(LCD1602_I2C_MockBus_t* mock);
+
+/**
+ * @brief Check for an injected fault at this point of a transaction, a stuck bus or a timeout uses up the whole timeout
+ * @name LCD1602_I2C_Mock_Fault
+ * @return Return LCD1602_I2C_OK if the transaction goes on, the injected status otherwise
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_Mock_Fault(LCD1602_I2C_MockBus_t* mock, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Feed a byte written to the PCF8574 to the controller model, latching a nibble on each EN falling edge (a whole byte in 8-bit mode, DB0..DB3 from low)
+ * @name LCD1602_I2C_Mock_Pins
+ */
+static void LCD1602_I2C_Mock_Pins(LCD1602_I2C_MockLCD_t* lcd, __UINT8_TYPE__ pins, __UINT32_TYPE__ now);
+
+/**
+ * @brief Execute a complete instruction/data write in the controller model
+ * @name LCD1602_I2C_Mock_Execute
+ */
+static void LCD1602_I2C_Mock_Execute(LCD1602_I2C_MockLCD_t* lcd, __UINT8_TYPE__ rs, __UINT8_TYPE__ value, __UINT32_TYPE__ now);
+
+/**
+ * @brief Move the address counter by one, following the DDRAM line layout
+ * @name LCD1602_I2C_Mock_StepAddress
+ */
+static void LCD1602_I2C_Mock_StepAddress(LCD1602_I2C_MockLCD_t* lcd);
+
+/**
+ * @brief Load the data register from the RAM cell the address counter points to
+ * @name LCD1602_I2C_Mock_LoadData
+ */
+static void LCD1602_I2C_Mock_LoadData(LCD1602_I2C_MockLCD_t* lcd);
+
+/**
+ * @brief Find the controller model of the device answering to an address
+ * @name LCD1602_I2C_Mock_Device
+ * @return Return the controller model, 0 if no device on the bus has this address
+ */
+static LCD1602_I2C_MockLCD_t* LCD1602_I2C_Mock_Device(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ address);
+
+/**
+ * @brief Get the nibble on DB4..DB7 of a PCF8574 value
+ * @name LCD1602_I2C_Mock_Nibble
+ */
+static __UINT8_TYPE__ LCD1602_I2C_Mock_Nibble(__UINT8_TYPE__ pins);
+
+
+// Global variables
+const LCD1602_I2C_Transport_t LCD1602_I2C_Transport_Mock = {
+    .write = LCD1602_I2C_Mock_Write,
+    .read = LCD1602_I2C_Mock_Read,
+    .probe = LCD1602_I2C_Mock_Probe,
+    .delayUs = LCD1602_I2C_Mock_DelayUs,
+    .micros = LCD1602_I2C_Mock_Micros,
+    .writeAsync = LCD1602_I2C_Mock_WriteAsync,
+    .recover = LCD1602_I2C_Mock_Recover,
+    .transfer = LCD1602_I2C_Mock_Segments,
+    .timeResolutionUs = 1,
+};
+
+
+// Local functions definition
+
+LCD1602_I2C_Status_t LCD1602_I2C_Mock_Write(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs){
+    LCD1602_I2C_MockBus_t* mock = (LCD1602_I2C_MockBus_t*)bus;
+    LCD1602_I2C_MockLCD_t* lcd = LCD1602_I2C_Mock_Device(mock, address);
+    __UINT16_TYPE__ faultAt = (mock->faultAfter < length) ? mock->faultAfter : length;
+
+    LCD1602_I2C_Mock_Transaction(mock);
+    if(mock->stuck) return LCD1602_I2C_Mock_Fault(mock, timeoutUs);
+    LCD1602_I2C_Mock_Byte(mock, LCD1602_I2C_MOCK_PROBE, address, 0); // Address byte
+    if(!lcd) return LCD1602_I2C_NACK; // Not acknowledged
+    lcd->port = 0; // A PCF8575 transaction starts with port 0
+
+    for(__UINT16_TYPE__ i = 0; i < length; i++){
+        __UINT32_TYPE__ now = 0;
+        if(mock->faultCount && i == faultAt) return LCD1602_I2C_Mock_Fault(mock, timeoutUs); // The bytes before the fault reached the PCF8574
+        now = LCD1602_I2C_Mock_Byte(mock, LCD1602_I2C_MOCK_WRITE, address, data[i]);
+        if(lcd->expander == LCD1602_I2C_PCF8575){ // Both ports are updated together after the second byte
+            __UINT8_TYPE__ ctrl = 0;
+            lcd->ports[lcd->port] = data[i];
+            lcd->port ^= 1;
+            if(lcd->port) continue;
+            ctrl |= (lcd->ports[1] & PCF8575_PIN_RS) ? PIN_RS : 0x00;
+            ctrl |= (lcd->ports[1] & PCF8575_PIN_RW) ? PIN_RW : 0x00;
+            ctrl |= (lcd->ports[1] & PCF8575_PIN_EN) ? PIN_EN : 0x00;
+            ctrl |= (lcd->ports[1] & PCF8575_PIN_BL) ? PIN_BL : 0x00;
+            lcd->low = lcd->ports[0] & 0x0F;
+            LCD1602_I2C_Mock_Pins(lcd, ctrl | LCD1602_I2C_NIBBLE_PINS(lcd->ports[0] >> 4), now);
+            continue;
+        }
+        LCD1602_I2C_Mock_Pins(lcd, data[i], now); // The PCF8574 updates its pins after the acknowledge
+    }
+    if(mock->faultCount) return LCD1602_I2C_Mock_Fault(mock, timeoutUs); // Every byte went through, the STOP did not
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Mock_Read(void* bus, __UINT8_TYPE__ address, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs){
+    LCD1602_I2C_MockBus_t* mock = (LCD1602_I2C_MockBus_t*)bus;
+    LCD1602_I2C_MockLCD_t* lcd = LCD1602_I2C_Mock_Device(mock, address);
+    __UINT8_TYPE__ dataPins = PIN_DB4 | PIN_DB5 | PIN_DB6 | PIN_DB7;
+    __UINT8_TYPE__ value = 0;
+
+    LCD1602_I2C_Mock_Transaction(mock);
+    mock->reads++;
+    if(mock->stuck || mock->faultCount) return LCD1602_I2C_Mock_Fault(mock, timeoutUs);
+    LCD1602_I2C_Mock_Byte(mock, LCD1602_I2C_MOCK_PROBE, address, 0); // Address byte
+    if(!lcd) return LCD1602_I2C_NACK;
+
+    if(lcd->expander == LCD1602_I2C_PCF8575){ // Port 0 then port 1, the controller drives DB0..DB7
+        value = lcd->ports[0];
+        if((lcd->pins & PIN_RW) && (lcd->pins & PIN_EN)) value &= lcd->readByte;
+        for(__UINT16_TYPE__ i = 0; i < length; i++){
+            data[i] = (i & 1) ? lcd->ports[1] : value;
+            LCD1602_I2C_Mock_Byte(mock, LCD1602_I2C_MOCK_READ, address, data[i]);
+        }
+        return LCD1602_I2C_OK;
+    }
+    value = lcd->pins;
+    if((lcd->pins & PIN_RW) && (lcd->pins & PIN_EN)){ // The controller drives DB4..DB7, pins written low stay low
+        __UINT8_TYPE__ nibble = (lcd->phase == 0) ? (lcd->readByte >> 4) : (lcd->readByte & 0x0F);
+        __UINT8_TYPE__ driven = LCD1602_I2C_NIBBLE_PINS(nibble);
+        value = (lcd->pins & ~dataPins) | (lcd->pins & dataPins & driven);
+    }
+    for(__UINT16_TYPE__ i = 0; i < length; i++){
+        data[i] = value;
+        LCD1602_I2C_Mock_Byte(mock, LCD1602_I2C_MOCK_READ, address, value);
+    }
+    return LCD1602_I2C_OK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Mock_Probe(void* bus, __UINT8_TYPE__ address, __UINT32_TYPE__ timeoutUs){
+    LCD1602_I2C_MockBus_t* mock = (LCD1602_I2C_MockBus_t*)bus;
+
+    LCD1602_I2C_Mock_Transaction(mock);
+    mock->probes++;
+    if(mock->stuck || mock->faultCount) return LCD1602_I2C_Mock_Fault(mock, timeoutUs);
+    LCD1602_I2C_Mock_Byte(mock, LCD1602_I2C_MOCK_PROBE, address, 0);
+    return LCD1602_I2C_Mock_Device(mock, address) ? LCD1602_I2C_OK : LCD1602_I2C_NACK;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Mock_Recover(void* bus){
+    LCD1602_I2C_MockBus_t* mock = (LCD1602_I2C_MockBus_t*)bus;
+    __UINT64_TYPE__ unlockNs = 10000000ULL / mock->busKhz; // 9 clocks + STOP
+
+    mock->nowNs += unlockNs;
+    mock->busNs += unlockNs;
+    mock->recoveries++;
+    mock->stuck = 0;
+    return LCD1602_I2C_OK;
+}
+
+
+void LCD1602_I2C_Mock_DelayUs(void* bus, __UINT32_TYPE__ us){
+    LCD1602_I2C_MockBus_t* mock = (LCD1602_I2C_MockBus_t*)bus;
+    mock->delayNs += (__UINT64_TYPE__)us * 1000;
+    mock->nowNs += (__UINT64_TYPE__)us * 1000;
+}
+
+
+__UINT32_TYPE__ LCD1602_I2C_Mock_Micros(void* bus){
+    return (__UINT32_TYPE__)(((LCD1602_I2C_MockBus_t*)bus)->nowNs / 1000);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Mock_Segments(void* bus, __UINT8_TYPE__ address, const LCD1602_I2C_Segment_t* segments, __UINT8_TYPE__ count, __UINT32_TYPE__ timeoutUs){
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+
+    for(__UINT8_TYPE__ i = 0; i < count && status == LCD1602_I2C_OK; i++){
+        if(segments[i].read){
+            status = LCD1602_I2C_Mock_Read(bus, address, segments[i].data, segments[i].length, timeoutUs);
+        } else {
+            status = LCD1602_I2C_Mock_Write(bus, address, segments[i].data, segments[i].length, timeoutUs);
+        }
+    }
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Mock_WriteAsync(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length){
+    LCD1602_I2C_MockBus_t* mock = (LCD1602_I2C_MockBus_t*)bus;
+
+    if(mock->asyncData) return LCD1602_I2C_BUSY;
+    if(!LCD1602_I2C_Mock_Device(mock, address)) return LCD1602_I2C_NACK;
+    mock->asyncData = data;
+    mock->asyncLength = length;
+    mock->asyncAddress = address;
+    return LCD1602_I2C_OK;
+}
+
+
+__UINT32_TYPE__ LCD1602_I2C_Mock_Byte(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ type, __UINT8_TYPE__ address, __UINT8_TYPE__ data){
+    __UINT64_TYPE__ byteNs = 9000000ULL / mock->busKhz; // 8 data bits + acknowledge
+
+    mock->nowNs += byteNs;
+    mock->busNs += byteNs;
+    mock->bytes++;
+    if(mock->log && mock->logLength < mock->logCapacity){
+        LCD1602_I2C_MockRecord_t* record = &mock->log[mock->logLength++];
+        record->timestampUs = (__UINT32_TYPE__)(mock->nowNs / 1000);
+        record->type = type;
+        record->address = address;
+        record->data = data;
+    }
+    return (__UINT32_TYPE__)(mock->nowNs / 1000);
+}
+
+
+void LCD1602_I2C_Mock_Transaction(LCD1602_I2C_MockBus_t* mock){
+    __UINT64_TYPE__ conditionNs = 2000000ULL / mock->busKhz; // START + STOP, about one bit time each
+
+    mock->nowNs += conditionNs;
+    mock->busNs += conditionNs;
+    mock->transactions++;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_Mock_Fault(LCD1602_I2C_MockBus_t* mock, __UINT32_TYPE__ timeoutUs){
+    LCD1602_I2C_Status_t status = mock->stuck ? LCD1602_I2C_BUS_ERROR : mock->faultStatus;
+
+    if(!mock->stuck) mock->faultCount--;
+    mock->faults++;
+    if(mock->stuck || status == LCD1602_I2C_TIMEOUT){ // The backend waits until it gives up
+        mock->nowNs += (__UINT64_TYPE__)timeoutUs * 1000;
+        mock->busNs += (__UINT64_TYPE__)timeoutUs * 1000;
+    }
+    return status;
+}
+
+
+void LCD1602_I2C_Mock_Pins(LCD1602_I2C_MockLCD_t* lcd, __UINT8_TYPE__ pins, __UINT32_TYPE__ now){
+    __UINT8_TYPE__ previous = lcd->pins;
+    lcd->pins = pins;
+
+    if(!(previous & PIN_EN) && (pins & PIN_EN) && (pins & PIN_RW) && lcd->phase == 0){ // Start of a read, sample the register
+        if(pins & PIN_RS){
+            lcd->readByte = lcd->dataRegister; // Stale after a data write, as on the real part
+        } else {
+            lcd->readByte = ((now < lcd->busyUntil) ? 0x80 : 0x00) | (lcd->ac & 0x7F);
+        }
+    }
+
+    if(!((previous & PIN_EN) && !(pins & PIN_EN))) return; // Nibbles are latched on the falling edge of EN
+
+    __UINT8_TYPE__ nibble = LCD1602_I2C_Mock_Nibble(previous);
+    __UINT8_TYPE__ rs = (previous & PIN_RS) ? 1 : 0;
+
+    if(!lcd->fourBit){ // 8-bit mode, DB0..DB3 are not wired behind a PCF8574 and read as 0
+        if(!(previous & PIN_RW)){
+            LCD1602_I2C_Mock_Execute(lcd, rs, (nibble << 4) | lcd->low, now);
+        } else if(rs){ // End of a read
+            if(now < lcd->busyUntil) lcd->violations++;
+            lcd->dataReads++;
+            LCD1602_I2C_Mock_StepAddress(lcd);
+            LCD1602_I2C_Mock_LoadData(lcd);
+        }
+        return;
+    }
+    if(lcd->phase == 0){
+        lcd->highNibble = nibble;
+        lcd->phase = 1;
+        return;
+    }
+    lcd->phase = 0;
+    if(previous & PIN_RW){ // End of a read
+        if(rs){
+            if(now < lcd->busyUntil) lcd->violations++;
+            lcd->dataReads++;
+            LCD1602_I2C_Mock_StepAddress(lcd);
+            LCD1602_I2C_Mock_LoadData(lcd);
+        }
+        return;
+    }
+    LCD1602_I2C_Mock_Execute(lcd, rs, (lcd->highNibble << 4) | nibble, now);
+}
+
+
+void LCD1602_I2C_Mock_Execute(LCD1602_I2C_MockLCD_t* lcd, __UINT8_TYPE__ rs, __UINT8_TYPE__ value, __UINT32_TYPE__ now){
+    __UINT32_TYPE__ execUs = 37;
+    __UINT8_TYPE__ lineLength = lcd->twoLines ? 40 : 80;
+
+    if(now < lcd->busyUntil){ // Not accepted while busy
+        lcd->violations++;
+        return;
+    }
+
+    if(rs){ // Data write
+        if(lcd->cgramSelected){
+            lcd->cgram[lcd->ac & 0x3F] = value;
+        } else {
+            lcd->ddram[lcd->ac & 0x7F] = value;
+            if(lcd->shift) lcd->origin = lcd->increment ? (lcd->origin + 1) % lineLength : (lcd->origin + lineLength - 1) % lineLength;
+        }
+        LCD1602_I2C_Mock_StepAddress(lcd);
+        lcd->dataRegister = value; // Written through the data register, not reloaded
+        lcd->dataWrites++;
+        lcd->busyUntil = now + 41;
+        return;
+    }
+
+    lcd->instructions++;
+    if(value & 0x80){ // Set DDRAM address
+        lcd->ac = value & 0x7F;
+        lcd->cgramSelected = 0;
+        LCD1602_I2C_Mock_LoadData(lcd);
+    } else if(value & 0x40){ // Set CGRAM address
+        lcd->ac = value & 0x3F;
+        lcd->cgramSelected = 1;
+        LCD1602_I2C_Mock_LoadData(lcd);
+    } else if(value & 0x20){ // Function set
+        if(!lcd->fourBit && lcd->resetPulses < 2){ // Power-on sequence: 4.1ms then 100us
+            execUs = (lcd->resetPulses == 0) ? 4100 : 100;
+            lcd->resetPulses++;
+        }
+        lcd->fourBit = (value & 0x10) ? 0 : 1;
+        lcd->twoLines = (value & 0x08) ? 1 : 0;
+        lcd->phase = 0;
+    } else if(value & 0x10){ // Cursor or display shift
+        if(value & 0x08){
+            lcd->origin = (value & 0x04) ? (lcd->origin + lineLength - 1) % lineLength : (lcd->origin + 1) % lineLength;
+        } else {
+            __UINT8_TYPE__ increment = lcd->increment;
+            lcd->increment = (value & 0x04) ? 1 : 0;
+            LCD1602_I2C_Mock_StepAddress(lcd);
+            lcd->increment = increment;
+            LCD1602_I2C_Mock_LoadData(lcd);
+        }
+    } else if(value & 0x08){ // Display control
+        lcd->displayOn = (value & 0x04) ? 1 : 0;
+        lcd->cursorOn = (value & 0x02) ? 1 : 0;
+        lcd->blinkOn = (value & 0x01) ? 1 : 0;
+    } else if(value & 0x04){ // Entry mode set
+        lcd->increment = (value & 0x02) ? 1 : 0;
+        lcd->shift = (value & 0x01) ? 1 : 0;
+    } else if(value & 0x02){ // Return home
+        lcd->ac = 0;
+        lcd->cgramSelected = 0;
+        lcd->origin = 0;
+        execUs = 1520;
+    } else if(value & 0x01){ // Clear display
+        memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+        lcd->ac = 0;
+        lcd->cgramSelected = 0;
+        lcd->origin = 0;
+        lcd->increment = 1;
+        execUs = 1520;
+    }
+    lcd->busyUntil = now + execUs;
+}
+
+
+void LCD1602_I2C_Mock_StepAddress(LCD1602_I2C_MockLCD_t* lcd){
+    if(lcd->cgramSelected){
+        lcd->ac = (lcd->ac + (lcd->increment ? 1 : 0x3F)) & 0x3F;
+        return;
+    }
+    if(!lcd->twoLines){ // One line: 0x00..0x4F
+        lcd->ac = lcd->increment ? ((lcd->ac >= 0x4F) ? 0x00 : lcd->ac + 1) : ((lcd->ac == 0x00) ? 0x4F : lcd->ac - 1);
+        return;
+    }
+    if(lcd->increment){ // Two lines: 0x00..0x27 then 0x40..0x67
+        if(lcd->ac == 0x27) lcd->ac = 0x40;
+        else if(lcd->ac >= 0x67) lcd->ac = 0x00;
+        else lcd->ac++;
+    } else {
+        if(lcd->ac == 0x40) lcd->ac = 0x27;
+        else if(lcd->ac == 0x00) lcd->ac = 0x67;
+        else lcd->ac--;
+    }
+}
+
+
+void LCD1602_I2C_Mock_LoadData(LCD1602_I2C_MockLCD_t* lcd){
+    lcd->dataRegister = lcd->cgramSelected ? lcd->cgram[lcd->ac & 0x3F] : lcd->ddram[lcd->ac & 0x7F];
+}
+
+
+LCD1602_I2C_MockLCD_t* LCD1602_I2C_Mock_Device(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ address){
+    for(LCD1602_I2C_MockBus_t* device = mock; device; device = device->next){
+        if(device->address == address) return &device->lcd;
+    }
+    return 0;
+}
+
+
+__UINT8_TYPE__ LCD1602_I2C_Mock_Nibble(__UINT8_TYPE__ pins){
+    return ((pins & PIN_DB4) ? 0x1 : 0x0) | ((pins & PIN_DB5) ? 0x2 : 0x0) | ((pins & PIN_DB6) ? 0x4 : 0x0) | ((pins & PIN_DB7) ? 0x8 : 0x0);
+}
+
+
+// Global functions definition
+
+void LCD1602_I2C_Mock_Init(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ address, __UINT32_TYPE__ busKhz, LCD1602_I2C_MockRecord_t* log, __UINT32_TYPE__ logCapacity){
+    memset(mock, 0, sizeof(*mock));
+    mock->address = address;
+    mock->busKhz = busKhz;
+    mock->log = log;
+    mock->logCapacity = logCapacity;
+    memset(mock->lcd.ddram, ' ', sizeof(mock->lcd.ddram));
+    mock->lcd.increment = 1;
+    mock->lcd.busyUntil = 40000; // Power-on: the controller is not ready before 40ms
+}
+
+
+void LCD1602_I2C_Mock_AddDevice(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_MockBus_t* device){
+    device->next = mock->next;
+    mock->next = device;
+}
+
+
+void LCD1602_I2C_Mock_ResetCounters(LCD1602_I2C_MockBus_t* mock){
+    mock->logLength = 0;
+    mock->transactions = 0;
+    mock->bytes = 0;
+    mock->probes = 0;
+    mock->reads = 0;
+    mock->busNs = 0;
+    mock->delayNs = 0;
+    mock->faults = 0;
+    mock->recoveries = 0;
+    mock->lcd.instructions = 0;
+    mock->lcd.dataWrites = 0;
+    mock->lcd.dataReads = 0;
+    mock->lcd.violations = 0;
+}
+
+
+void LCD1602_I2C_Mock_InjectFault(LCD1602_I2C_MockBus_t* mock, __UINT32_TYPE__ count, LCD1602_I2C_Status_t status, __UINT16_TYPE__ after){
+    mock->faultCount = count;
+    mock->faultStatus = status;
+    mock->faultAfter = after;
+}
+
+
+void LCD1602_I2C_Mock_Advance(LCD1602_I2C_MockBus_t* mock, __UINT32_TYPE__ us){
+    mock->nowNs += (__UINT64_TYPE__)us * 1000;
+}
+
+
+int LCD1602_I2C_Mock_CompleteAsync(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_t* lcd){
+    const __UINT8_TYPE__* data = mock->asyncData;
+
+    if(!data) return 0;
+    mock->asyncData = 0;
+    if(LCD1602_I2C_Mock_Write(mock, mock->asyncAddress, data, mock->asyncLength, 0) == LCD1602_I2C_OK){ // Interrupt driven transfers have no timeout
+        LCD1602_I2C_AsyncTxComplete(lcd);
+    } else {
+        LCD1602_I2C_AsyncTxError(lcd);
+    }
+    return 1;
+}
+
+
+void LCD1602_I2C_Mock_DrainAsync(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_t* lcd){
+    while(LCD1602_I2C_AsyncQueueDepth(lcd) > 0){
+        if(!LCD1602_I2C_Mock_CompleteAsync(mock, lcd)){ // Nothing on the bus, the drain is settling
+            LCD1602_I2C_Mock_Advance(mock, 10);
+            LCD1602_I2C_AsyncPoll(lcd);
+        }
+    }
+}
+
+
+void LCD1602_I2C_Mock_DrainSched(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_Sched_t* sched){
+    while(LCD1602_I2C_SchedQueueDepth(sched) > 0){
+        const __UINT8_TYPE__* data = mock->asyncData;
+        __UINT32_TYPE__ wait = 0;
+
+        if(data){ // Transfer complete or error interrupt
+            mock->asyncData = 0;
+            if(LCD1602_I2C_Mock_Write(mock, mock->asyncAddress, data, mock->asyncLength, 0) == LCD1602_I2C_OK){
+                LCD1602_I2C_SchedTxComplete(sched);
+            } else {
+                LCD1602_I2C_SchedTxError(sched);
+            }
+            continue;
+        }
+        wait = LCD1602_I2C_SchedPoll(sched);
+        if(!mock->asyncData) LCD1602_I2C_Mock_Advance(mock, wait ? wait : 1); // Idle bus until the earliest deadline
+    }
+}
+
+
+void LCD1602_I2C_Mock_ReadRow(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ row, char* out, __UINT8_TYPE__ cols){
+    LCD1602_I2C_MockLCD_t* lcd = &mock->lcd;
+    __UINT8_TYPE__ lineLength = lcd->twoLines ? 40 : 80;
+
+    for(__UINT8_TYPE__ x = 0; x < cols; x++){
+        out[x] = (char)lcd->ddram[((row & 1) ? 0x40 : 0x00) + (lcd->origin + (row >> 1) * cols + x) % lineLength]; // Rows 2 and 3 of a 4 rows display continue rows 0 and 1
+    }
+    out[cols] = '\0';
+}
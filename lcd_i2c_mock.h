@@ -0,0 +1,177 @@
+/**
+ * @author: Trong Phan Minh
+ * @date: 19/01/2026
+ * @brief: In-memory transport for host builds (tests, benchmarks). Every byte on the virtual bus is counted and optionally recorded with its timestamp, and the frames are decoded by a model of the HD44780U so reads (busy flag, DDRAM) return what a real controller would. Time is virtual: it only advances with bus traffic and delays. Bus faults can be injected to exercise the recovery.
+ */
+
+
+#ifndef LCD_I2C_MOCK_H
+#define LCD_I2C_MOCK_H
+
+// Additional library includes
+#include "lcd_i2c.h"
+
+// Typedef
+typedef enum {
+    LCD1602_I2C_MOCK_WRITE = 0, // Data byte written by the master
+    LCD1602_I2C_MOCK_READ, // Data byte read by the master
+    LCD1602_I2C_MOCK_PROBE // Address only transaction
+} LCD1602_I2C_MockRecordType_t;
+
+typedef struct {
+    __UINT32_TYPE__ timestampUs; // When the byte was on the wire
+    __UINT8_TYPE__ type; // LCD1602_I2C_MockRecordType_t
+    __UINT8_TYPE__ address; // Device address (8-bit form)
+    __UINT8_TYPE__ data; // The byte, 0 for probes
+} LCD1602_I2C_MockRecord_t;
+
+/*
+ * Model of the HD44780U behind the PCF8574 (or a PCF8575 with expander set, wired as PCF8575_PIN_RS...)
+ * - Instructions latched while the controller is busy are ignored (as on the real part) and counted in violations
+ * - Execution times: 1.52ms for Clear/Return home, 37us for other instructions, 41us for data, 4.1ms/100us for the first two 8-bit function sets
+ */
+typedef struct {
+    __UINT8_TYPE__ ddram[128]; // Indexed by DDRAM address
+    __UINT8_TYPE__ cgram[64]; // Indexed by CGRAM address
+    __UINT8_TYPE__ ac; // Address counter
+    __UINT8_TYPE__ cgramSelected; // Set to 1 when the address counter points to CGRAM
+    __UINT8_TYPE__ increment; // Entry mode I/D
+    __UINT8_TYPE__ shift; // Entry mode S
+    __UINT8_TYPE__ displayOn, cursorOn, blinkOn; // Display control D, C, B
+    __UINT8_TYPE__ fourBit; // Set to 1 after the 4-bit function set
+    __UINT8_TYPE__ twoLines; // Function set N
+    __UINT8_TYPE__ origin; // DDRAM column shown in the first display column (display shift)
+    __UINT8_TYPE__ phase; // 0: next nibble is the higher one, 1: the lower one (4-bit mode)
+    __UINT8_TYPE__ highNibble; // Higher nibble waiting for the lower one
+    __UINT8_TYPE__ readByte; // Byte being read out, nibble by nibble
+    __UINT8_TYPE__ dataRegister; // DR: loaded from RAM by address sets, cursor shifts and reads, holds the byte of the last data write otherwise
+    __UINT8_TYPE__ pins; // Last value written to P0..P7 (PCF8575: port 1 control lines and DB4..DB7 as PCF8574 pins)
+    __UINT8_TYPE__ low; // DB0..DB3, always 0 behind a PCF8574
+    __UINT8_TYPE__ expander; // LCD1602_I2C_Expander_t, set after LCD1602_I2C_Mock_Init
+    __UINT8_TYPE__ ports[2]; // Last values written to PCF8575 port 0 (DB0..DB7) and port 1
+    __UINT8_TYPE__ port; // PCF8575 port the next byte of the transaction goes to
+    __UINT8_TYPE__ resetPulses; // 8-bit function sets seen so far, for the power-on sequence timing
+    __UINT32_TYPE__ busyUntil; // Timestamp (us) at which the current instruction ends
+    __UINT32_TYPE__ instructions; // Instructions executed
+    __UINT32_TYPE__ dataWrites; // Data written to DDRAM/CGRAM
+    __UINT32_TYPE__ dataReads; // Data read from DDRAM/CGRAM
+    __UINT32_TYPE__ violations; // Transfers ignored because the controller was busy
+} LCD1602_I2C_MockLCD_t;
+
+typedef struct LCD1602_I2C_MockBus LCD1602_I2C_MockBus_t;
+
+/*
+ * Virtual bus with one PCF8574 + HD44780U, more devices can be chained on the same wires with LCD1602_I2C_Mock_AddDevice
+ * - Time, traffic counters, log and the pending asynchronous write belong to the bus the driver talks to
+ * - The other devices only contribute their address and controller model
+ */
+struct LCD1602_I2C_MockBus {
+    __UINT8_TYPE__ address; // Address the PCF8574 answers to (8-bit form), addresses of no device on the bus are not acknowledged
+    __UINT32_TYPE__ busKhz; // Bus clock used to advance the virtual time
+    LCD1602_I2C_MockRecord_t* log; // Optional record storage, 0 to only count
+    __UINT32_TYPE__ logCapacity; // Number of records log can hold
+    __UINT32_TYPE__ logLength; // Number of records stored, stops growing when the log is full
+    __UINT64_TYPE__ nowNs; // Virtual time
+    __UINT32_TYPE__ transactions; // I2C transactions (START ... STOP), probes included
+    __UINT32_TYPE__ bytes; // Bytes on the wire, address bytes included
+    __UINT32_TYPE__ probes; // Probe transactions
+    __UINT32_TYPE__ reads; // Read transactions
+    __UINT64_TYPE__ busNs; // Time the bus was busy
+    __UINT64_TYPE__ delayNs; // Time spent in delays
+    __UINT32_TYPE__ faultCount; // Transactions left to fail (LCD1602_I2C_Mock_InjectFault)
+    LCD1602_I2C_Status_t faultStatus; // Status of the failing transactions, LCD1602_I2C_TIMEOUT also uses up their timeout
+    __UINT16_TYPE__ faultAfter; // Data bytes of a failing write that still reach the PCF8574
+    __UINT8_TYPE__ stuck; // Set to 1 for a slave holding SDA low: every transaction fails with LCD1602_I2C_BUS_ERROR after its timeout until the recover hook runs
+    __UINT32_TYPE__ faults; // Transactions failed by an injected fault or the stuck bus
+    __UINT32_TYPE__ recoveries; // Calls of the recover hook
+    const __UINT8_TYPE__* asyncData; // Pending asynchronous write, 0 if none
+    __UINT16_TYPE__ asyncLength;
+    __UINT8_TYPE__ asyncAddress;
+    LCD1602_I2C_MockLCD_t lcd; // Controller model
+    LCD1602_I2C_MockBus_t* next; // Next device on the same bus, 0 for the last one
+};
+
+// Global variables
+extern const LCD1602_I2C_Transport_t LCD1602_I2C_Transport_Mock;
+
+// Global functions declaration
+/**
+ * @brief Initialize a mock bus with a powered-off controller at timestamp 0
+ * @name LCD1602_I2C_Mock_Init
+ * @param mock: Pointer to the mock bus
+ * @param address: Address the PCF8574 answers to (8-bit form)
+ * @param busKhz: Bus clock in kHz
+ * @param log: Optional record storage, 0 to only count
+ * @param logCapacity: Number of records log can hold
+ */
+extern void LCD1602_I2C_Mock_Init(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ address, __UINT32_TYPE__ busKhz, LCD1602_I2C_MockRecord_t* log, __UINT32_TYPE__ logCapacity);
+
+/**
+ * @brief Put another device on the bus of a mock, the driver keeps talking to mock and reaches the device by its address
+ * @name LCD1602_I2C_Mock_AddDevice
+ * @param mock: Pointer to the mock bus
+ * @param device: Pointer to a mock initialized with LCD1602_I2C_Mock_Init at a free address, only its controller model is used
+ */
+extern void LCD1602_I2C_Mock_AddDevice(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_MockBus_t* device);
+
+/**
+ * @brief Reset the traffic counters and the record log, the virtual time and the controller are kept
+ * @name LCD1602_I2C_Mock_ResetCounters
+ * @param mock: Pointer to the mock bus
+ */
+extern void LCD1602_I2C_Mock_ResetCounters(LCD1602_I2C_MockBus_t* mock);
+
+/**
+ * @brief Make the next transactions fail (set stuck instead for a bus held low)
+ * @name LCD1602_I2C_Mock_InjectFault
+ * @param mock: Pointer to the mock bus
+ * @param count: Number of transactions to fail, 0 to stop
+ * @param status: The status they return (LCD1602_I2C_NACK, _BUS_ERROR, _TIMEOUT)
+ * @param after: Data bytes of a failing write sent before the fault, the PCF8574 latches them
+ */
+extern void LCD1602_I2C_Mock_InjectFault(LCD1602_I2C_MockBus_t* mock, __UINT32_TYPE__ count, LCD1602_I2C_Status_t status, __UINT16_TYPE__ after);
+
+/**
+ * @brief Advance the virtual time
+ * @name LCD1602_I2C_Mock_Advance
+ * @param mock: Pointer to the mock bus
+ * @param us: Time to add in us
+ */
+extern void LCD1602_I2C_Mock_Advance(LCD1602_I2C_MockBus_t* mock, __UINT32_TYPE__ us);
+
+/**
+ * @brief Put the pending asynchronous write on the virtual bus and fire LCD1602_I2C_AsyncTxComplete, like a transfer complete interrupt
+ * @name LCD1602_I2C_Mock_CompleteAsync
+ * @param mock: Pointer to the mock bus
+ * @param lcd: The display context that started the write
+ * @return Return 1 if a write was pending, 0 otherwise
+ */
+extern int LCD1602_I2C_Mock_CompleteAsync(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Run the asynchronous drain until the queue is empty: complete the pending writes, poll the driver and advance the virtual time through the settle times
+ * @name LCD1602_I2C_Mock_DrainAsync
+ * @param mock: Pointer to the mock bus
+ * @param lcd: The display context whose queue is drained
+ */
+extern void LCD1602_I2C_Mock_DrainAsync(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_t* lcd);
+
+/**
+ * @brief Run a bus scheduler until every queue is empty: complete the pending writes through LCD1602_I2C_SchedTxComplete and advance the virtual time to the next display deadline when the bus is idle
+ * @name LCD1602_I2C_Mock_DrainSched
+ * @param mock: Pointer to the mock bus
+ * @param sched: The scheduler of the displays on this bus
+ */
+extern void LCD1602_I2C_Mock_DrainSched(LCD1602_I2C_MockBus_t* mock, LCD1602_I2C_Sched_t* sched);
+
+/**
+ * @brief Copy the characters visible on a row, taking the display shift into account
+ * @name LCD1602_I2C_Mock_ReadRow
+ * @param mock: Pointer to the mock bus (or a device added to it)
+ * @param row: The row (0 to 3)
+ * @param out: Pointer to at least cols + 1 bytes, receives a null-terminated string
+ * @param cols: Number of visible columns
+ */
+extern void LCD1602_I2C_Mock_ReadRow(LCD1602_I2C_MockBus_t* mock, __UINT8_TYPE__ row, char* out, __UINT8_TYPE__ cols);
+
+#endif // LCD_I2C_MOCK_H
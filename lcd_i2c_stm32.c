@@ -0,0 +1,208 @@
+#include "lcd_i2c_stm32.h"
+
+// Local functions declaration
+
+/**
+ * @brief Transport write, HAL_I2C_Master_Transmit
+ * @name LCD1602_I2C_STM32_Write
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_STM32_Write(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport read, HAL_I2C_Master_Receive
+ * @name LCD1602_I2C_STM32_Read
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_STM32_Read(void* bus, __UINT8_TYPE__ address, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport probe, HAL_I2C_IsDeviceReady with a single trial
+ * @name LCD1602_I2C_STM32_Probe
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_STM32_Probe(void* bus, __UINT8_TYPE__ address, __UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport recover, 9 SCL clocks and a STOP by GPIO when the pins are given (LCD1602_I2C_STM32_SCL_PORT...), then HAL_I2C_DeInit/HAL_I2C_Init to reset the peripheral
+ * @name LCD1602_I2C_STM32_Recover
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_STM32_Recover(void* bus);
+
+/**
+ * @brief Convert a HAL status to a driver status, HAL_I2C_GetError tells a NACK from a bus error
+ * @name LCD1602_I2C_STM32_Status
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_STM32_Status(I2C_HandleTypeDef* hi2c, HAL_StatusTypeDef status);
+
+/**
+ * @brief Convert a timeout to HAL ticks, rounded up with one more tick as HAL_GetTick may be about to change
+ * @name LCD1602_I2C_STM32_Ticks
+ */
+static __UINT32_TYPE__ LCD1602_I2C_STM32_Ticks(__UINT32_TYPE__ timeoutUs);
+
+/**
+ * @brief Transport delay, DWT busy wait or HAL_Delay rounded up to the next ms
+ * @name LCD1602_I2C_STM32_DelayUs
+ */
+static void LCD1602_I2C_STM32_DelayUs(void* bus, __UINT32_TYPE__ us);
+
+/**
+ * @brief Transport timestamp, DWT cycle counter or HAL_GetTick in us
+ * @name LCD1602_I2C_STM32_Micros
+ */
+static __UINT32_TYPE__ LCD1602_I2C_STM32_Micros(void* bus);
+
+/**
+ * @brief Transport asynchronous write, HAL_I2C_Master_Transmit_IT (or _DMA). Forward HAL_I2C_MasterTxCpltCallback to LCD1602_I2C_AsyncTxComplete and HAL_I2C_ErrorCallback to LCD1602_I2C_AsyncTxError, with the display context of the interrupting I2C_HandleTypeDef (or to LCD1602_I2C_SchedTxComplete/LCD1602_I2C_SchedTxError with its scheduler when displays share the bus).
+ * @name LCD1602_I2C_STM32_WriteAsync
+ */
+static LCD1602_I2C_Status_t LCD1602_I2C_STM32_WriteAsync(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length);
+
+
+// Global variables
+const LCD1602_I2C_Transport_t LCD1602_I2C_Transport_STM32 = {
+    .write = LCD1602_I2C_STM32_Write,
+    .read = LCD1602_I2C_STM32_Read,
+    .probe = LCD1602_I2C_STM32_Probe,
+    .delayUs = LCD1602_I2C_STM32_DelayUs,
+    .micros = LCD1602_I2C_STM32_Micros,
+    .writeAsync = LCD1602_I2C_STM32_WriteAsync,
+    .recover = LCD1602_I2C_STM32_Recover,
+#if LCD1602_I2C_USE_DWT
+    .timeResolutionUs = 1,
+#else
+    .timeResolutionUs = 1000, // A ms tick may be up to 1ms late
+#endif
+};
+
+
+// Local functions definition
+
+LCD1602_I2C_Status_t LCD1602_I2C_STM32_Write(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs){
+    HAL_StatusTypeDef status = HAL_I2C_Master_Transmit((I2C_HandleTypeDef*)bus, address, (__UINT8_TYPE__*)data, length, LCD1602_I2C_STM32_Ticks(timeoutUs));
+    return LCD1602_I2C_STM32_Status((I2C_HandleTypeDef*)bus, status);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_STM32_Read(void* bus, __UINT8_TYPE__ address, __UINT8_TYPE__* data, __UINT16_TYPE__ length, __UINT32_TYPE__ timeoutUs){
+    HAL_StatusTypeDef status = HAL_I2C_Master_Receive((I2C_HandleTypeDef*)bus, address, data, length, LCD1602_I2C_STM32_Ticks(timeoutUs));
+    return LCD1602_I2C_STM32_Status((I2C_HandleTypeDef*)bus, status);
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_STM32_Probe(void* bus, __UINT8_TYPE__ address, __UINT32_TYPE__ timeoutUs){
+    HAL_StatusTypeDef status = HAL_I2C_IsDeviceReady((I2C_HandleTypeDef*)bus, address, 1, LCD1602_I2C_STM32_Ticks(timeoutUs)); // The driver recovers and probes again on its own
+    LCD1602_I2C_Status_t result = LCD1602_I2C_STM32_Status((I2C_HandleTypeDef*)bus, status);
+    return (result == LCD1602_I2C_ERROR) ? LCD1602_I2C_NACK : result; // Not every HAL version sets HAL_I2C_ERROR_AF when the trials run out
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_STM32_Recover(void* bus){
+    I2C_HandleTypeDef* hi2c = (I2C_HandleTypeDef*)bus;
+    LCD1602_I2C_Status_t status = LCD1602_I2C_OK;
+
+    HAL_I2C_DeInit(hi2c); // Releases the pins (HAL_I2C_MspDeInit) and clears a BUSY flag stuck in the peripheral
+#if defined(LCD1602_I2C_STM32_SCL_PORT) && defined(LCD1602_I2C_STM32_SCL_PIN) && defined(LCD1602_I2C_STM32_SDA_PORT) && defined(LCD1602_I2C_STM32_SDA_PIN)
+    {
+        GPIO_InitTypeDef gpio = {0};
+        __UINT32_TYPE__ halfPeriod = SystemCoreClock / 400000 + 1; // At least 5us per level (100kHz or slower), a turn of the loop takes several cycles
+
+        gpio.Mode = GPIO_MODE_OUTPUT_OD;
+        gpio.Pull = GPIO_NOPULL;
+        gpio.Speed = GPIO_SPEED_FREQ_LOW;
+        HAL_GPIO_WritePin(LCD1602_I2C_STM32_SCL_PORT, LCD1602_I2C_STM32_SCL_PIN, GPIO_PIN_SET);
+        HAL_GPIO_WritePin(LCD1602_I2C_STM32_SDA_PORT, LCD1602_I2C_STM32_SDA_PIN, GPIO_PIN_SET);
+        gpio.Pin = LCD1602_I2C_STM32_SCL_PIN;
+        HAL_GPIO_Init(LCD1602_I2C_STM32_SCL_PORT, &gpio);
+        gpio.Pin = LCD1602_I2C_STM32_SDA_PIN;
+        HAL_GPIO_Init(LCD1602_I2C_STM32_SDA_PORT, &gpio); // Open-drain high, still reads the level driven by the slave
+
+        // Up to 9 clocks: the slave holding SDA low shifts out the rest of its byte, then sees no acknowledge
+        for(__UINT8_TYPE__ i = 0; i < 9 && HAL_GPIO_ReadPin(LCD1602_I2C_STM32_SDA_PORT, LCD1602_I2C_STM32_SDA_PIN) == GPIO_PIN_RESET; i++){
+            HAL_GPIO_WritePin(LCD1602_I2C_STM32_SCL_PORT, LCD1602_I2C_STM32_SCL_PIN, GPIO_PIN_RESET);
+            for(volatile __UINT32_TYPE__ t = 0; t < halfPeriod; t++);
+            HAL_GPIO_WritePin(LCD1602_I2C_STM32_SCL_PORT, LCD1602_I2C_STM32_SCL_PIN, GPIO_PIN_SET);
+            for(volatile __UINT32_TYPE__ t = 0; t < halfPeriod; t++);
+        }
+
+        // STOP: SDA rises while SCL is high
+        HAL_GPIO_WritePin(LCD1602_I2C_STM32_SCL_PORT, LCD1602_I2C_STM32_SCL_PIN, GPIO_PIN_RESET);
+        HAL_GPIO_WritePin(LCD1602_I2C_STM32_SDA_PORT, LCD1602_I2C_STM32_SDA_PIN, GPIO_PIN_RESET);
+        for(volatile __UINT32_TYPE__ t = 0; t < halfPeriod; t++);
+        HAL_GPIO_WritePin(LCD1602_I2C_STM32_SCL_PORT, LCD1602_I2C_STM32_SCL_PIN, GPIO_PIN_SET);
+        for(volatile __UINT32_TYPE__ t = 0; t < halfPeriod; t++);
+        HAL_GPIO_WritePin(LCD1602_I2C_STM32_SDA_PORT, LCD1602_I2C_STM32_SDA_PIN, GPIO_PIN_SET);
+        for(volatile __UINT32_TYPE__ t = 0; t < halfPeriod; t++);
+
+        if(HAL_GPIO_ReadPin(LCD1602_I2C_STM32_SDA_PORT, LCD1602_I2C_STM32_SDA_PIN) == GPIO_PIN_RESET) status = LCD1602_I2C_BUS_ERROR; // Still held low
+    }
+#endif
+    if(HAL_I2C_Init(hi2c) != HAL_OK) return LCD1602_I2C_ERROR; // HAL_I2C_MspInit gives the pins back to the peripheral
+    return status;
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_STM32_Status(I2C_HandleTypeDef* hi2c, HAL_StatusTypeDef status){
+    __UINT32_TYPE__ error = 0;
+
+    if(status == HAL_OK) return LCD1602_I2C_OK;
+    if(status == HAL_BUSY) return LCD1602_I2C_BUS_ERROR; // BUSY flag still set after the timeout: SDA or SCL held low
+    error = HAL_I2C_GetError(hi2c);
+    if(error & HAL_I2C_ERROR_AF) return LCD1602_I2C_NACK;
+    if(error & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_ARLO)) return LCD1602_I2C_BUS_ERROR;
+    if(status == HAL_TIMEOUT || (error & HAL_I2C_ERROR_TIMEOUT)) return LCD1602_I2C_TIMEOUT;
+    return LCD1602_I2C_ERROR;
+}
+
+
+__UINT32_TYPE__ LCD1602_I2C_STM32_Ticks(__UINT32_TYPE__ timeoutUs){
+    return (timeoutUs + 999) / 1000 + 1;
+}
+
+
+void LCD1602_I2C_STM32_DelayUs(void* bus, __UINT32_TYPE__ us){
+#if LCD1602_I2C_USE_DWT
+    __UINT32_TYPE__ start = LCD1602_I2C_STM32_Micros(bus);
+    while(LCD1602_I2C_STM32_Micros(bus) - start < us);
+#else
+    HAL_Delay((us + 999) / 1000); // Rounded up, HAL_Delay adds one more tick on its own
+#endif
+}
+
+
+__UINT32_TYPE__ LCD1602_I2C_STM32_Micros(void* bus){
+#if LCD1602_I2C_USE_DWT
+    static __UINT32_TYPE__ lastCycles = 0;
+    static __UINT32_TYPE__ us = 0;
+    __UINT32_TYPE__ cyclesPerUs = SystemCoreClock / 1000000;
+    __UINT32_TYPE__ now = 0;
+
+    LCD1602_I2C_ENTER_CRITICAL(); // Called from the application, the completion interrupt and the tasks of other buses, an update cut in two would count the elapsed time twice
+    __UINT32_TYPE__ elapsed = (DWT->CYCCNT - lastCycles) / cyclesPerUs; // Must be called at least once per CYCCNT wrap-around
+    us += elapsed;
+    lastCycles += elapsed * cyclesPerUs; // Keep the remainder for the next call
+    now = us;
+    LCD1602_I2C_EXIT_CRITICAL();
+    return now;
+#else
+    return HAL_GetTick() * 1000;
+#endif
+}
+
+
+LCD1602_I2C_Status_t LCD1602_I2C_STM32_WriteAsync(void* bus, __UINT8_TYPE__ address, const __UINT8_TYPE__* data, __UINT16_TYPE__ length){
+#if LCD1602_I2C_ASYNC_USE_DMA
+    return (LCD1602_I2C_Status_t)HAL_I2C_Master_Transmit_DMA((I2C_HandleTypeDef*)bus, address, (__UINT8_TYPE__*)data, length);
+#else
+    return (LCD1602_I2C_Status_t)HAL_I2C_Master_Transmit_IT((I2C_HandleTypeDef*)bus, address, (__UINT8_TYPE__*)data, length);
+#endif
+}
+
+
+// Global functions definition
+
+#if LCD1602_I2C_USE_DWT
+void LCD1602_I2C_DWT_Init(void){
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+#endif
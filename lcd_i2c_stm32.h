@@ -0,0 +1,36 @@
+/**
+ * @author: Trong Phan Minh
+ * @date: 19/01/2026
+ * @brief: STM32 HAL transport for the LCD1602 driver. Pass &LCD1602_I2C_Transport_STM32 and a pointer to your I2C_HandleTypeDef to LCD1602_I2C_Init.
+ */
+
+
+#ifndef LCD_I2C_STM32_H
+#define LCD_I2C_STM32_H
+
+// Additional library includes
+#include "main.h"
+#include "lcd_i2c.h"
+
+// Macros
+#ifndef LCD1602_I2C_USE_DWT
+#define LCD1602_I2C_USE_DWT 0 // Set to 1 to use the Cortex-M DWT cycle counter as us timestamp/delay (call LCD1602_I2C_DWT_Init first), otherwise HAL_GetTick/HAL_Delay are used
+#endif
+#ifndef LCD1602_I2C_ASYNC_USE_DMA
+#define LCD1602_I2C_ASYNC_USE_DMA 0 // Set to 1 to drain the asynchronous queue with HAL_I2C_Master_Transmit_DMA instead of HAL_I2C_Master_Transmit_IT
+#endif
+// Define LCD1602_I2C_STM32_SCL_PORT/_SCL_PIN and LCD1602_I2C_STM32_SDA_PORT/_SDA_PIN (e.g. GPIOB, GPIO_PIN_6) to clock a slave holding SDA low free during the bus recovery, otherwise only the I2C peripheral is reset
+
+// Global variables
+extern const LCD1602_I2C_Transport_t LCD1602_I2C_Transport_STM32;
+
+// Global functions declaration
+#if LCD1602_I2C_USE_DWT
+/**
+ * @brief Enable the DWT cycle counter used as us timestamp
+ * @name LCD1602_I2C_DWT_Init
+ */
+extern void LCD1602_I2C_DWT_Init(void);
+#endif
+
+#endif // LCD_I2C_STM32_H